@@ -278,6 +278,7 @@ pub fn build(b: *std.Build) void {
     dnh_mod.linkSystemLibrary("ole32", .{});
     dnh_mod.linkSystemLibrary("oleaut32", .{});
     dnh_mod.linkSystemLibrary("pdh", .{});
+    dnh_mod.linkSystemLibrary("shell32", .{});
     dnh_mod.linkLibrary(zlib);
     dnh_mod.linkLibrary(ogg);
     dnh_mod.linkLibrary(vorbis);
@@ -355,8 +356,10 @@ pub fn build(b: *std.Build) void {
             "TouhouDanmakufu/Common/StgSystem.cpp",
             "TouhouDanmakufu/Common/StgUserExtendScene.cpp",
             "TouhouDanmakufu/Common/DnhConfiguration.cpp",
+            "TouhouDanmakufu/DnhExecutor/Benchmark.cpp",
             "TouhouDanmakufu/DnhExecutor/Common.cpp",
             "TouhouDanmakufu/DnhExecutor/GcLibImpl.cpp",
+            "TouhouDanmakufu/DnhExecutor/Headless.cpp",
             "TouhouDanmakufu/DnhExecutor/ScriptSelectScene.cpp",
             "TouhouDanmakufu/DnhExecutor/StgScene.cpp",
             "TouhouDanmakufu/DnhExecutor/System.cpp",
@@ -33,6 +33,7 @@ DirectGraphicsConfig::DirectGraphicsConfig() {
 	typeMultiSample = D3DMULTISAMPLE_NONE;
 	
 	bUseRef = false;
+	bUseNullRef = false;
 	bUseTripleBuffer = true;
 	bVSync = false;
 	
@@ -93,9 +94,10 @@ bool DirectGraphics::Initialize(HWND hWnd, const DirectGraphicsConfig& config) {
 	pDirect3D->GetDeviceCaps(D3DADAPTER_DEFAULT, D3DDEVTYPE_REF, &capsRef);
 	pDirect3D->GetDeviceCaps(D3DADAPTER_DEFAULT, D3DDEVTYPE_HAL, &capsHal);
 
-	D3DDEVTYPE deviceType = config.bUseRef ? D3DDEVTYPE_REF : D3DDEVTYPE_HAL;
-	deviceCaps_ = deviceType == D3DDEVTYPE_REF ? capsRef : capsHal;
-	if (config.bCheckDeviceCaps && !config.bUseRef)
+	D3DDEVTYPE deviceType = config.bUseNullRef ? D3DDEVTYPE_NULLREF
+		: (config.bUseRef ? D3DDEVTYPE_REF : D3DDEVTYPE_HAL);
+	deviceCaps_ = deviceType == D3DDEVTYPE_HAL ? capsHal : capsRef;
+	if (config.bCheckDeviceCaps && deviceType == D3DDEVTYPE_HAL)
 		_VerifyDeviceCaps();
 
 	bool bDeviceVSyncAvailable = (deviceCaps_.PresentationIntervals & D3DPRESENT_INTERVAL_ONE) != 0;
@@ -215,7 +217,15 @@ bool DirectGraphics::Initialize(HWND hWnd, const DirectGraphicsConfig& config) {
 				hrDevice = pDirect3D->CreateDevice(D3DADAPTER_DEFAULT, type, hWnd, 
 					addFlag | D3DCREATE_MULTITHREADED | D3DCREATE_FPU_PRESERVE, d3dpp, &pDevice_);
 			};
-			if (config.bUseRef) {
+			if (config.bUseNullRef) {
+				//Needs no GPU or reference rasterizer, the caps are taken from the device itself
+				_TryCreateDevice(D3DDEVTYPE_NULLREF, D3DCREATE_SOFTWARE_VERTEXPROCESSING);
+				if (SUCCEEDED(hrDevice)) {
+					pDevice_->GetDeviceCaps(&deviceCaps_);
+					Logger::WriteTop("DirectGraphics: Created device (D3DDEVTYPE_NULLREF)");
+				}
+			}
+			else if (config.bUseRef) {
 				_TryCreateDevice(D3DDEVTYPE_REF, D3DCREATE_SOFTWARE_VERTEXPROCESSING);
 			}
 			else {
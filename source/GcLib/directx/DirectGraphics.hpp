@@ -36,6 +36,7 @@ namespace directx {
 		D3DMULTISAMPLE_TYPE typeMultiSample;
 
 		bool bUseRef;
+		bool bUseNullRef;		//D3DDEVTYPE_NULLREF, resources can be created but nothing is drawn or presented
 		bool bUseTripleBuffer;
 		bool bVSync;
 
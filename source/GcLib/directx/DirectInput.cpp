@@ -569,23 +569,11 @@ bool VirtualKeyManager::IsTargetKeyCode(int16_t keyCode) {
 //*******************************************************************
 KeyReplayManager::KeyReplayManager(VirtualKeyManager* input) {
 	frame_ = 0;
+	indexReplayData_ = 0;
 	input_ = input;
 	state_ = STATE_RECORD;
 }
 
-void KeyReplayManager::_AddData(ReplayData&& data) {
-	auto itrFind = mapReplayData_.find(data.frame);
-	if (itrFind != mapReplayData_.end()) {
-		itrFind->second.push_back(MOVE(data));
-	}
-	else {
-		std::vector<ReplayData> listData;
-		listData.push_back(MOVE(data));
-
-		mapReplayData_.insert({ data.frame, listData });
-	}
-}
-
 void KeyReplayManager::AddTarget(int16_t key) {
 	mapKeyTarget_[key] = KEY_FREE;
 }
@@ -599,10 +587,7 @@ void KeyReplayManager::Update() {
 				// Read actual state
 				state = input_->GetVirtualKeyState(idKey);
 
-				ReplayData data = {
-					idKey, frame_, state
-				};
-				_AddData(MOVE(data));
+				listReplayData_.push_back({ idKey, frame_, state });
 			}
 		}
 		else {
@@ -612,10 +597,7 @@ void KeyReplayManager::Update() {
 				DIKeyState currentState = input_->GetVirtualKeyState(idKey);
 
 				if (currentState != oldState) {
-					ReplayData data = {
-						idKey, frame_, currentState
-					};
-					_AddData(MOVE(data));
+					listReplayData_.push_back({ idKey, frame_, currentState });
 
 					oldState = currentState;
 				}
@@ -624,15 +606,11 @@ void KeyReplayManager::Update() {
 	}
 	else if (state_ == STATE_REPLAY) {
 		// Load state changes for the current frame (if one exists)
-		auto itrCurrentFrame = mapReplayData_.find(frame_);
-		if (itrCurrentFrame != mapReplayData_.end()) {
-			auto& [_, listData] = *itrCurrentFrame;
-
-			for (auto& keyData : listData) {
-				mapKeyTarget_[keyData.id] = keyData.state;
-			}
+		for (; indexReplayData_ < listReplayData_.size(); ++indexReplayData_) {
+			const ReplayData& keyData = listReplayData_[indexReplayData_];
+			if (keyData.frame > frame_) break;
 
-			//mapReplayData_.erase(itrCurrentFrame);
+			mapKeyTarget_[keyData.id] = keyData.state;
 		}
 
 		// Apply the current replay key state (overwriting existing realtime key data)
@@ -654,36 +632,76 @@ bool KeyReplayManager::IsTargetKeyCode(int16_t key) {
 	return false;
 }
 
+//Stream format, one entry per state change:
+//	varint		frames since the previous change
+//	varint		(uint16_t)key id << 2 | state
 void KeyReplayManager::ReadRecord(RecordBuffer& record) {
-	if (auto data = record.GetRecordAs<uint32_t>("count")) {
-		auto countReplayData = *data;
-
-		ByteBuffer buffer(sizeof(ReplayData) * countReplayData);
+	listReplayData_.clear();
+	indexReplayData_ = 0;
+
+	if (record.IsExists("stream")) {
+		std::vector<byte> stream(record.GetEntrySize("stream"));
+		if (stream.size() > 0)
+			record.GetRecord("stream", stream.data(), stream.size());
+
+		const byte* pos = stream.data();
+		const byte* end = pos + stream.size();
+		auto _ReadVarint = [&](uint32_t* res) {
+			*res = 0;
+			for (size_t shift = 0; pos < end && shift < 32; shift += 7) {
+				byte b = *(pos++);
+				*res |= (uint32_t)(b & 0x7f) << shift;
+				if ((b & 0x80) == 0) return true;
+			}
+			return false;
+		};
 
-		record.GetRecord("data", buffer.GetPointer(), buffer.GetSize());
+		listReplayData_.reserve(record.GetRecordOr<uint32_t>("countStream", 0));
 
-		for (size_t iRec = 0; iRec < countReplayData; ++iRec) {
-			ReplayData data{};
-			buffer.Read(&data, sizeof(ReplayData));
+		uint32_t frame = 0;
+		while (pos < end) {
+			uint32_t frameDelta = 0;
+			uint32_t keyAndState = 0;
+			if (!_ReadVarint(&frameDelta) || !_ReadVarint(&keyAndState)) {
+				Logger::WriteWarn("KeyReplayManager::ReadRecord: Replay key stream is truncated");
+				break;
+			}
 
-			_AddData(MOVE(data));
+			frame += frameDelta;
+			listReplayData_.push_back({ (int16_t)(uint16_t)(keyAndState >> 2), frame,
+				(DIKeyState)(keyAndState & 0b11) });
 		}
 	}
+	else if (auto data = record.GetRecordAs<uint32_t>("count")) {
+		//Replays from older versions, fixed-size entries already in frame order
+		auto countReplayData = *data;
+
+		listReplayData_.resize(countReplayData);
+		if (countReplayData > 0)
+			record.GetRecord("data", listReplayData_.data(), sizeof(ReplayData) * countReplayData);
+	}
 }
 void KeyReplayManager::WriteRecord(RecordBuffer& record) {
-	// Flatten frames data from map
-	std::vector<ReplayData> listDataFlatten;
-	for (auto& [_, listData] : mapReplayData_) {
-		listDataFlatten.insert(listDataFlatten.end(), listData.begin(), listData.end());
-	};
+	std::vector<byte> stream;
+	stream.reserve(listReplayData_.size() * 2);
 
-	record.SetRecord<uint32_t>("count", listDataFlatten.size());
+	auto _WriteVarint = [&](uint32_t val) {
+		while (val >= 0x80) {
+			stream.push_back((byte)(val | 0x80));
+			val >>= 7;
+		}
+		stream.push_back((byte)val);
+	};
 
-	ByteBuffer buffer;
-	for (auto& data : listDataFlatten) {
-		buffer.Write(&data, sizeof(ReplayData));
+	uint32_t frame = 0;
+	for (auto& data : listReplayData_) {
+		_WriteVarint(data.frame - frame);
+		_WriteVarint(((uint32_t)(uint16_t)data.id << 2) | (data.state & 0b11));
+		frame = data.frame;
 	}
-	record.SetRecord("data", buffer.GetPointer(), buffer.GetSize());
+
+	record.SetRecord<uint32_t>("countStream", listReplayData_.size());
+	record.SetRecord("stream", stream.data(), stream.size());
 }
 
 #endif
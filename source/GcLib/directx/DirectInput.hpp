@@ -215,11 +215,11 @@ namespace directx {
 		
 		std::map<int16_t, DIKeyState> mapKeyTarget_;
 
-		std::map<uint32_t, std::vector<ReplayData>> mapReplayData_;
+		//Key state changes in frame order, recording appends to the end
+		std::vector<ReplayData> listReplayData_;
+		size_t indexReplayData_;	//Playback cursor, first change not yet applied
 
 		VirtualKeyManager* input_;
-	private:
-		void _AddData(ReplayData&& data);
 	public:
 		KeyReplayManager(VirtualKeyManager* input);
 		virtual ~KeyReplayManager() {}
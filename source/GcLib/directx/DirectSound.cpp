@@ -25,9 +25,11 @@ DirectSoundManager::~DirectSoundManager() {
 	Logger::WriteTop("DirectSound: Finalizing.");
 	this->Clear();
 
-	threadManage_->Stop();
-	threadManage_->Join();
-	threadManage_ = nullptr;
+	if (threadManage_) {
+		threadManage_->Stop();
+		threadManage_->Join();
+		threadManage_ = nullptr;
+	}
 
 	for (auto itr = mapDivision_.begin(); itr != mapDivision_.end(); ++itr)
 		ptr_delete(itr->second);
@@ -92,6 +94,15 @@ bool DirectSoundManager::Initialize(HWND hWnd) {
 	thisBase_ = this;
 	return true;
 }
+bool DirectSoundManager::InitializeSilent() {
+	if (thisBase_) return false;
+
+	//No device, CreatePlayer always fails and scripts see every sound as unloaded
+	Logger::WriteTop("DirectSound: Initialized without an output device.");
+
+	thisBase_ = this;
+	return true;
+}
 void DirectSoundManager::Clear() {
 	try {
 		Lock lock(lock_);
@@ -207,7 +218,7 @@ shared_ptr<SoundSourceData> DirectSoundManager::_CreateSoundSource(std::wstring
 	return res;
 }
 shared_ptr<SoundPlayer> DirectSoundManager::CreatePlayer(shared_ptr<SoundSourceData> source) {
-	if (source == nullptr) return nullptr;
+	if (source == nullptr || pDirectSound_ == nullptr) return nullptr;
 
 	const std::wstring& path = source->path_;
 	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
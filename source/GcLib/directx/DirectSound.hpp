@@ -62,6 +62,7 @@ namespace directx {
 		static DirectSoundManager* GetBase() { return thisBase_; }
 
 		virtual bool Initialize(HWND hWnd);
+		bool InitializeSilent();
 		void Clear();
 
 		const DSCAPS* GetDeviceCaps() const { return &dxSoundCaps_; }
@@ -10,6 +10,70 @@
 using namespace gstd;
 using namespace directx;
 
+//****************************************************************************
+//DxScriptObjectValueMap
+//****************************************************************************
+std::shared_mutex DxScriptObjectValueMap::lockKey_;
+std::unordered_map<std::wstring, DxScriptObjectValueMap::key_t, DxScriptObjectValueMap::_KeyHash, std::equal_to<>>
+	DxScriptObjectValueMap::mapKey_;
+std::atomic<size_t> DxScriptObjectValueMap::countMap_ = 0;
+
+DxScriptObjectValueMap::DxScriptObjectValueMap() {
+	countMap_.fetch_add(1, std::memory_order_relaxed);
+}
+DxScriptObjectValueMap::DxScriptObjectValueMap(const DxScriptObjectValueMap& other) : listValue_(other.listValue_) {
+	countMap_.fetch_add(1, std::memory_order_relaxed);
+}
+DxScriptObjectValueMap::~DxScriptObjectValueMap() {
+	if (countMap_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+	//No map is left to hold a key, start over. A map created meanwhile has no keys yet,
+	//	and interning for it waits on the lock
+	std::unique_lock<std::shared_mutex> lock(lockKey_);
+	if (countMap_.load(std::memory_order_acquire) == 0)
+		mapKey_.clear();
+}
+
+DxScriptObjectValueMap::key_t DxScriptObjectValueMap::GetKey(std::wstring_view name, bool bCreate) {
+	//Scripts in their Loading event may run on the load thread
+	{
+		std::shared_lock<std::shared_mutex> lock(lockKey_);
+
+		auto itrFind = mapKey_.find(name);
+		if (itrFind != mapKey_.end())
+			return itrFind->second;
+		if (!bCreate)
+			return INVALID_KEY;
+	}
+
+	//Another thread may have interned it in between
+	std::unique_lock<std::shared_mutex> lock(lockKey_);
+	return mapKey_.try_emplace(std::wstring(name), (key_t)mapKey_.size()).first->second;
+}
+
+std::vector<DxScriptObjectValueMap::entry_t>::iterator DxScriptObjectValueMap::_Find(key_t key) {
+	return std::lower_bound(listValue_.begin(), listValue_.end(), key,
+		[](const entry_t& entry, key_t key) { return entry.first < key; });
+}
+gstd::value* DxScriptObjectValueMap::Find(key_t key) {
+	auto itr = _Find(key);
+	if (itr == listValue_.end() || itr->first != key) return nullptr;
+	return &itr->second;
+}
+void DxScriptObjectValueMap::Set(key_t key, const gstd::value& val) {
+	auto itr = _Find(key);
+	if (itr != listValue_.end() && itr->first == key)
+		itr->second = val;
+	else
+		listValue_.emplace(itr, key, val);
+}
+bool DxScriptObjectValueMap::Erase(key_t key) {
+	auto itr = _Find(key);
+	if (itr == listValue_.end() || itr->first != key) return false;
+	listValue_.erase(itr);
+	return true;
+}
+
 //****************************************************************************
 //DxScriptObjectBase
 //****************************************************************************
@@ -33,7 +97,10 @@ DxScriptObjectBase::~DxScriptObjectBase() {
 }
 
 void DxScriptObjectBase::Clone(DxScriptObjectBase* src) {
-	idScript_ = src->idScript_;
+	if (manager_)
+		manager_->SetObjectScriptID(this, src->idScript_);
+	else
+		idScript_ = src->idScript_;
 
 	bActive_ = src->bActive_;
 	bVisible_ = src->bVisible_;
@@ -1485,6 +1552,7 @@ int DxScriptObjectManager::AddObject(ref_unsync_ptr<DxScriptObjectBase> obj, boo
 			}
 			obj->idObject_ = res;
 			obj->manager_ = this;
+			_AddScriptObject(obj.get());
 
 			++totalObjectCreateCount_;
 		}
@@ -1531,6 +1599,7 @@ void DxScriptObjectManager::_DeleteObject(int id) {
 	if (pObj->manager_)
 		pObj->manager_->listUnusedIndex_.push_back(id);
 
+	_RemoveScriptObject(pObj.get());
 	obj_[id] = nullptr;
 	pObj->idObject_ = DxScript::ID_INVALID;
 }
@@ -1550,44 +1619,62 @@ void DxScriptObjectManager::DeleteObject(DxScriptObjectBase* obj) {
 	listDeleteObject_.push_back(obj->idObject_);
 }
 
+void DxScriptObjectManager::_AddScriptObject(DxScriptObjectBase* obj) {
+	if (obj->idScript_ == ScriptClientBase::ID_SCRIPT_FREE) return;
+	mapScriptObject_[obj->idScript_].insert(obj->idObject_);
+}
+void DxScriptObjectManager::_RemoveScriptObject(DxScriptObjectBase* obj) {
+	if (obj->idScript_ == ScriptClientBase::ID_SCRIPT_FREE) return;
+
+	auto itrFind = mapScriptObject_.find(obj->idScript_);
+	if (itrFind == mapScriptObject_.end()) return;
+
+	itrFind->second.erase(obj->idObject_);
+	if (itrFind->second.empty())
+		mapScriptObject_.erase(itrFind);
+}
+
 void DxScriptObjectManager::ClearObject() {
 	std::fill(obj_.begin(), obj_.end(), nullptr);
 	listActiveObject_.clear();
+	mapScriptObject_.clear();
 
 	listUnusedIndex_.clear();
 	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
 		listUnusedIndex_.push_back(iObj);
 	}
 }
-void DxScriptObjectManager::DeleteObjectByScriptID(int64_t idScript) {
-	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
+//Use this once the object is added, so the script index stays in sync
+void DxScriptObjectManager::SetObjectScriptID(DxScriptObjectBase* obj, int64_t idScript) {
+	bool bAdded = obj->idObject_ >= 0 && obj->idObject_ < obj_.size() && obj_[obj->idObject_].get() == obj;
 
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		auto& pObj = obj_[iObj];
-		if (pObj == nullptr) continue;
-		if (pObj->GetScriptID() != idScript) continue;
-		DeleteObject(pObj);
-	}
+	if (bAdded) _RemoveScriptObject(obj);
+	obj->idScript_ = idScript;
+	if (bAdded) _AddScriptObject(obj);
+}
+void DxScriptObjectManager::DeleteObjectByScriptID(int64_t idScript) {
+	for (int idObject : GetObjectByScriptID(idScript))
+		DeleteObject(idObject);
 }
 void DxScriptObjectManager::OrphanObjectByScriptID(int64_t idScript) {
 	if (idScript == ScriptClientBase::ID_SCRIPT_FREE) return;
 
-	for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-		auto& pObj = obj_[iObj];
-		if (pObj == nullptr) continue;
-		if (pObj->GetScriptID() != idScript) continue;
-		pObj->idScript_ = ScriptClientBase::ID_SCRIPT_FREE;
-	}
+	auto itrFind = mapScriptObject_.find(idScript);
+	if (itrFind == mapScriptObject_.end()) return;
+
+	for (int idObject : itrFind->second)
+		obj_[idObject]->idScript_ = ScriptClientBase::ID_SCRIPT_FREE;
+	mapScriptObject_.erase(itrFind);
 }
+//In ascending ID order, same as a scan of obj_ would give
 std::vector<int> DxScriptObjectManager::GetObjectByScriptID(int64_t idScript) {
 	std::vector<int> res;
 
 	if (idScript != ScriptClientBase::ID_SCRIPT_FREE) {
-		for (size_t iObj = 0; iObj < obj_.size(); ++iObj) {
-			auto& pObj = obj_[iObj];
-			if (pObj == nullptr) continue;
-			if (pObj->GetScriptID() != idScript) continue;
-			res.push_back(pObj->idObject_);
+		auto itrFind = mapScriptObject_.find(idScript);
+		if (itrFind != mapScriptObject_.end()) {
+			res.assign(itrFind->second.begin(), itrFind->second.end());
+			std::sort(res.begin(), res.end());
 		}
 	}
 	return res;
@@ -1608,16 +1695,20 @@ void DxScriptObjectManager::WorkObject() {
 	}
 	mapReservedSound_.clear();
 
-	for (auto itr = listActiveObject_.begin(); itr != listActiveObject_.end();) {
-		DxScriptObjectBase* obj = itr->get();
-		if (obj == nullptr || obj->IsDeleted()) {
-			itr = listActiveObject_.erase(itr);
-			continue;
-		}
+	//Objects activated during the loop are appended and worked in the same frame
+	size_t iWrite = 0;
+	for (size_t iRead = 0; iRead < listActiveObject_.size(); ++iRead) {
+		DxScriptObjectBase* obj = listActiveObject_[iRead].get();
+		if (obj == nullptr || obj->IsDeleted()) continue;
+
 		obj->Work();
 		++(obj->frameExist_);
-		++itr;
+
+		if (iWrite != iRead)
+			listActiveObject_[iWrite] = listActiveObject_[iRead];
+		++iWrite;
 	}
+	listActiveObject_.resize(iWrite);
 }
 void DxScriptObjectManager::RenderObject() {
 	PrepareRenderObject();
@@ -1662,18 +1753,22 @@ void DxScriptObjectManager::CleanupObject() {
 	listDeleteObject_.clear();
 }
 
-void DxScriptObjectManager::RenderList::Add(ref_unsync_ptr<DxScriptObjectBase>& ptr) {
+void DxScriptObjectManager::RenderList::Add(DxScriptObjectBase* ptr) {
 	if (size >= list.size())
 		list.push_back(ptr);
 	else
-		list[size++] = ptr;
+		list[size] = ptr;
+	++size;
 }
 void DxScriptObjectManager::RenderList::Clear() {
 	size = 0U;
-	std::fill(list.begin(), list.end(), nullptr);
 }
 void DxScriptObjectManager::PrepareRenderObject() {
-	for (auto& obj : listActiveObject_) {
+	//Priorities that weren't rendered since the last call may still hold last frame's pointers
+	ClearRenderObject();
+
+	for (auto& pObj : listActiveObject_) {
+		DxScriptObjectBase* obj = pObj.get();
 		if (obj == nullptr || obj->IsDeleted()) continue;
 		//Some render objects don't use normal rendering, thus sorting isn't required for them
 		if (!obj->HasNormalRendering()) continue;
@@ -1682,7 +1777,7 @@ void DxScriptObjectManager::PrepareRenderObject() {
 		AddRenderObject(obj);
 	}
 }
-void DxScriptObjectManager::AddRenderObject(ref_unsync_ptr<DxScriptObjectBase> obj) {
+void DxScriptObjectManager::AddRenderObject(DxScriptObjectBase* obj) {
 	size_t renderSize = listObjRender_.size();
 
 	int tPri = obj->priRender_;
@@ -15,6 +15,58 @@ namespace directx {
 	class DxScriptObjectManager;
 	class DxScriptObjectBase;
 
+	//****************************************************************************
+	//DxScriptObjectValueMap
+	//	Obj_SetValue storage, a small flat map keyed by IDs of keys interned once for all objects
+	//	The intern table holds every distinct key set since it was last emptied, which happens
+	//	whenever the last value map is destroyed, i.e. once no script object exists anywhere.
+	//	Keys built at runtime (e.g. "hit" ~ itoa(i)) add one entry per distinct string until then.
+	//****************************************************************************
+	class DxScriptObjectValueMap {
+	public:
+		using key_t = uint32_t;
+		static constexpr key_t INVALID_KEY = UINT32_MAX;
+
+		using entry_t = std::pair<key_t, gstd::value>;
+	private:
+		struct _KeyHash {
+			using is_transparent = void;
+			size_t operator()(std::wstring_view key) const { return std::hash<std::wstring_view>()(key); }
+		};
+
+		//Lookups take it shared, only interning a new key and emptying the table take it exclusively
+		static std::shared_mutex lockKey_;
+		static std::unordered_map<std::wstring, key_t, _KeyHash, std::equal_to<>> mapKey_;
+		static std::atomic<size_t> countMap_;
+
+		std::vector<entry_t> listValue_;	//Sorted by key
+
+		std::vector<entry_t>::iterator _Find(key_t key);
+	public:
+		DxScriptObjectValueMap();
+		DxScriptObjectValueMap(const DxScriptObjectValueMap& other);
+		~DxScriptObjectValueMap();
+
+		DxScriptObjectValueMap& operator=(const DxScriptObjectValueMap& other) = default;
+
+		//Returns INVALID_KEY if the key was never interned and bCreate is false
+		static key_t GetKey(std::wstring_view name, bool bCreate);
+
+		gstd::value* Find(key_t key);
+		void Set(key_t key, const gstd::value& val);
+		bool Erase(key_t key);
+
+		gstd::value* Find(const std::wstring& name) { return Find(GetKey(name, false)); }
+		void Set(const std::wstring& name, const gstd::value& val) { Set(GetKey(name, true), val); }
+		bool Erase(const std::wstring& name) { return Erase(GetKey(name, false)); }
+
+		size_t size() const { return listValue_.size(); }
+		void clear() { listValue_.clear(); }
+
+		std::vector<entry_t>::const_iterator begin() const { return listValue_.cbegin(); }
+		std::vector<entry_t>::const_iterator end() const { return listValue_.cend(); }
+	};
+
 	//****************************************************************************
 	//DxScriptObjectBase
 	//****************************************************************************
@@ -35,7 +87,7 @@ namespace directx {
 
 		uint32_t frameExist_;
 
-		std::unordered_map<std::wstring, gstd::value> mapObjectValue_;
+		DxScriptObjectValueMap mapObjectValue_;
 		std::unordered_map<int64_t, gstd::value> mapObjectValueI_;
 	public:
 		DxScriptObjectBase();
@@ -69,7 +121,7 @@ namespace directx {
 
 		uint32_t GetExistFrame() { return frameExist_; }
 
-		std::unordered_map<std::wstring, gstd::value>& GetValueMap() { return mapObjectValue_; }
+		DxScriptObjectValueMap& GetValueMap() { return mapObjectValue_; }
 		std::unordered_map<int64_t, gstd::value>& GetValueMapI() { return mapObjectValueI_; }
 	};
 
@@ -662,15 +714,16 @@ namespace directx {
 	class DxScriptObjectManager {
 		friend DxScriptObjectBase;
 	public:
+		//Only valid until the next WorkObject, listActiveObject_ keeps the objects alive until then
 		struct RenderList {
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>> list;
+			std::vector<DxScriptObjectBase*> list;
 			size_t size = 0;
 
-			void Add(ref_unsync_ptr<DxScriptObjectBase>& ptr);
+			void Add(DxScriptObjectBase* ptr);
 			void Clear();
 
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>>::const_iterator begin() { return list.cbegin(); }
-			std::vector<ref_unsync_ptr<DxScriptObjectBase>>::const_iterator end() { return begin() + size; }
+			std::vector<DxScriptObjectBase*>::const_iterator begin() { return list.cbegin(); }
+			std::vector<DxScriptObjectBase*>::const_iterator end() { return begin() + size; }
 		};
 		struct FogData {
 			bool enable;
@@ -686,12 +739,16 @@ namespace directx {
 		static FogData fogData_;
 	protected:
 		size_t totalObjectCreateCount_;
-		std::list<int> listUnusedIndex_;
+		std::deque<int> listUnusedIndex_;	//Reused first in, first out, so stale IDs stay dead for a while
 
 		std::vector<ref_unsync_ptr<DxScriptObjectBase>> obj_;
-		std::list<ref_unsync_ptr<DxScriptObjectBase>> listActiveObject_;
+		//Deleted objects are left in place and compacted out in WorkObject
+		std::vector<ref_unsync_ptr<DxScriptObjectBase>> listActiveObject_;
 		std::vector<int> listDeleteObject_;
 
+		//IDs of the objects owned by each script, so closing a script doesn't scan obj_
+		std::unordered_map<int64_t, std::unordered_set<int>> mapScriptObject_;
+
 		std::unordered_map<std::wstring, shared_ptr<SoundPlayer>> mapReservedSound_;
 
 		std::vector<RenderList> listObjRender_;
@@ -700,6 +757,9 @@ namespace directx {
 		void _SetObjectID(DxScriptObjectBase* obj, int index) { obj->idObject_ = index; obj->manager_ = this; }
 
 		void _DeleteObject(int id);
+
+		void _AddScriptObject(DxScriptObjectBase* obj);
+		void _RemoveScriptObject(DxScriptObjectBase* obj);
 	public:
 		DxScriptObjectManager();
 		virtual ~DxScriptObjectManager();
@@ -727,11 +787,12 @@ namespace directx {
 		virtual void DeleteObject(DxScriptObjectBase* obj);
 
 		void ClearObject();
+		void SetObjectScriptID(DxScriptObjectBase* obj, int64_t idScript);
 		void DeleteObjectByScriptID(int64_t idScript);
 		void OrphanObjectByScriptID(int64_t idScript);
 		std::vector<int> GetObjectByScriptID(int64_t idScript);
 
-		void AddRenderObject(ref_unsync_ptr<DxScriptObjectBase> obj);
+		void AddRenderObject(DxScriptObjectBase* obj);
 		void WorkObject();
 		virtual void RenderObject();
 		void CleanupObject();
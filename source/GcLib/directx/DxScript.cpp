@@ -1086,6 +1086,7 @@ value DxScript::Func_PlayBGM(script_machine* machine, int argc, const value* arg
 	shared_ptr<SoundSourceData> soundSource = manager->GetSoundSource(path, true);
 	if (soundSource) {
 		shared_ptr<SoundPlayer> player = manager->CreatePlayer(soundSource);
+		if (player == nullptr) return value();
 		player->SetAutoDelete(true);
 		player->SetSoundDivision(SoundDivision::DIVISION_BGM);
 
@@ -1112,6 +1113,7 @@ gstd::value DxScript::Func_PlaySE(gstd::script_machine* machine, int argc, const
 	shared_ptr<SoundSourceData> soundSource = manager->GetSoundSource(path, true);
 	if (soundSource) {
 		shared_ptr<SoundPlayer> player = manager->CreatePlayer(soundSource);
+		if (player == nullptr) return value();
 		player->SetAutoDelete(true);
 		player->SetSoundDivision(SoundDivision::DIVISION_SE);
 
@@ -2546,6 +2548,14 @@ gstd::value DxScript::Func_Obj_GetRenderPriorityI(gstd::script_machine* machine,
 	return script->CreateFloatValue(res);
 }
 
+//Looks up the interned ID of a value key, string keys are viewed in place where possible
+static DxScriptObjectValueMap::key_t _GetValueKey(const gstd::value& val, bool bCreate) {
+	std::wstring_view view;
+	if (val.as_string_view(&view))
+		return DxScriptObjectValueMap::GetKey(view, bCreate);
+	return DxScriptObjectValueMap::GetKey(val.as_string(), bCreate);
+}
+
 template<bool INTEGER>
 gstd::value DxScript::Func_Obj_GetValue(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	DxScript* script = (DxScript*)machine->data;
@@ -2556,12 +2566,11 @@ gstd::value DxScript::Func_Obj_GetValue(gstd::script_machine* machine, int argc,
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj) {
 		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
 			auto& pValueMap = obj->GetValueMap();
-			auto itr = pValueMap.find(key);
-			if (itr != pValueMap.end())
-				return itr->second;
+			if (pValueMap.size() > 0) {
+				if (gstd::value* pValue = pValueMap.Find(_GetValueKey(argv[1], false)))
+					return *pValue;
+			}
 		}
 		else {
 			int64_t key = argv[1].as_int();
@@ -2585,10 +2594,8 @@ gstd::value DxScript::Func_Obj_SetValue(gstd::script_machine* machine, int argc,
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj) {
 		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
 			auto& pValueMap = obj->GetValueMap();
-			pValueMap[key] = val;
+			pValueMap.Set(_GetValueKey(argv[1], true), val);
 		}
 		else {
 			int64_t key = argv[1].as_int();
@@ -2608,10 +2615,9 @@ gstd::value DxScript::Func_Obj_DeleteValue(gstd::script_machine* machine, int ar
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj) {
 		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
 			auto& pValueMap = obj->GetValueMap();
-			pValueMap.erase(key);
+			if (pValueMap.size() > 0)
+				pValueMap.Erase(_GetValueKey(argv[1], false));
 		}
 		else {
 			int64_t key = argv[1].as_int();
@@ -2633,10 +2639,8 @@ gstd::value DxScript::Func_Obj_IsValueExists(gstd::script_machine* machine, int
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj) {
 		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
 			auto& pValueMap = obj->GetValueMap();
-			res = pValueMap.find(key) != pValueMap.end();
+			res = pValueMap.size() > 0 && pValueMap.Find(_GetValueKey(argv[1], false)) != nullptr;
 		}
 		else {
 			int64_t key = argv[1].as_int();
@@ -2665,33 +2669,44 @@ gstd::value DxScript::Func_Obj_GetValueCount(gstd::script_machine* machine, int
 	return script->CreateIntValue(res);
 }
 
-template<typename T>
-static void _CopyValueTable(std::unordered_map<T, gstd::value>& srcMap, std::unordered_map<T, gstd::value>& dstMap, int mode) {
+static void _CopyValueTable(DxScriptObjectValueMap& srcMap, DxScriptObjectValueMap& dstMap, int mode) {
+	if (&srcMap == &dstMap) return;
+
 	//Mode 0 - Clear dest and copy
 	if (mode == 0) {
-		dstMap.clear();
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr)
-			dstMap.insert(*itr);
+		dstMap = srcMap;
 	}
 	//Mode 1 - Source takes priority (Always overwrite)
 	else if (mode == 1) {
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr) {
-			auto itrDst = srcMap.find(itr->first);
-			if (itrDst != srcMap.end())
-				itrDst->second = itr->second;
-			else
-				dstMap.insert(*itr);
-		}
+		for (auto& [key, val] : srcMap)
+			dstMap.Set(key, val);
 	}
 	//Mode 2 - Dest takes priority (No overwrite)
 	else if (mode == 2) {
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr) {
-			auto itrDst = srcMap.find(itr->first);
-			if (itrDst == srcMap.end())
-				dstMap.insert(*itr);
+		for (auto& [key, val] : srcMap) {
+			if (dstMap.Find(key) == nullptr)
+				dstMap.Set(key, val);
 		}
 	}
 }
+static void _CopyValueTable(std::unordered_map<int64_t, gstd::value>& srcMap, std::unordered_map<int64_t, gstd::value>& dstMap, int mode) {
+	if (&srcMap == &dstMap) return;
+
+	//Mode 0 - Clear dest and copy
+	if (mode == 0) {
+		dstMap = srcMap;
+	}
+	//Mode 1 - Source takes priority (Always overwrite)
+	else if (mode == 1) {
+		for (auto& [key, val] : srcMap)
+			dstMap[key] = val;
+	}
+	//Mode 2 - Dest takes priority (No overwrite)
+	else if (mode == 2) {
+		for (auto& [key, val] : srcMap)
+			dstMap.insert(std::make_pair(key, val));
+	}
+}
 
 template<bool INTEGER>
 gstd::value DxScript::Func_Obj_CopyValueTable(gstd::script_machine* machine, int argc, const gstd::value* argv) {
@@ -2761,7 +2776,7 @@ value DxScript::Func_Obj_SetParentScriptID(script_machine* machine, int argc, co
 	int64_t idScript = argc == 2 ? argv[1].as_int() : script->GetScriptID();
 
 	DxScriptObjectBase* obj = script->GetObjectPointerAs<DxScriptObjectBase>(id);
-	if (obj) obj->idScript_ = idScript;
+	if (obj) script->objManager_->SetObjectScriptID(obj, idScript);
 
 	return value();
 }
@@ -55,6 +55,8 @@ value DxScript::Func_Obj_Clone(script_machine* machine, int argc, const value* a
 			StgStageController* stageController = scriptStg->GetStageController();
 
 #define DEF_CASE(_type, _class) case _type: obj.reset(new _class(stageController)); break;
+			//Shots are allocated from the shot manager's pools
+#define DEF_CASE_SHOT(_type, _class) case _type: { auto objShot = stageController->GetShotManager()->CreateShotObject<_class>(); obj = objShot; break; }
 			switch (objSrc->typeObject_) {
 				DEF_CASE(TypeObject::Player, StgPlayerObject);
 				DEF_CASE(TypeObject::SpellManage, StgPlayerSpellManageObject);
@@ -64,10 +66,10 @@ value DxScript::Func_Obj_Clone(script_machine* machine, int argc, const value* a
 				DEF_CASE(TypeObject::EnemyBoss, StgEnemyBossObject);
 				DEF_CASE(TypeObject::EnemyBossScene, StgEnemyBossSceneObject);
 
-				DEF_CASE(TypeObject::Shot, StgNormalShotObject);
-				DEF_CASE(TypeObject::LooseLaser, StgLooseLaserObject);
-				DEF_CASE(TypeObject::StraightLaser, StgStraightLaserObject);
-				DEF_CASE(TypeObject::CurveLaser, StgCurveLaserObject);
+				DEF_CASE_SHOT(TypeObject::Shot, StgNormalShotObject);
+				DEF_CASE_SHOT(TypeObject::LooseLaser, StgLooseLaserObject);
+				DEF_CASE_SHOT(TypeObject::StraightLaser, StgStraightLaserObject);
+				DEF_CASE_SHOT(TypeObject::CurveLaser, StgCurveLaserObject);
 				DEF_CASE(TypeObject::ShotPattern, StgShotPatternGeneratorObject);
 			
 			case TypeObject::Item:
@@ -78,6 +80,7 @@ value DxScript::Func_Obj_Clone(script_machine* machine, int argc, const value* a
 				break;
 			}
 			}
+#undef DEF_CASE_SHOT
 #undef DEF_CASE
 		}
 
@@ -414,6 +414,66 @@ namespace directx {
 			"}"
 		"}";
 
+	//Instanced shots, each instance is a parallelogram (origin + two edges) with its own UV rect
+	const std::string ShaderSource::nameShotBatch_ = "_HLSL_INTERNAL_SHOT_BATCH";
+	const std::string ShaderSource::sourceShotBatch_ =
+		"sampler samp0_ : register(s0);"
+		"float4x4 g_mViewProj : VIEWPROJECTION : register(c0);"
+
+		"struct VS_INPUT {"
+			"float4 position : POSITION;"
+			"float4 diffuse : COLOR0;"
+			"float2 texCoord : TEXCOORD0;"
+
+			"float4 i_color : COLOR1;"
+			"float4 i_pos_edgex : TEXCOORD1;"
+			"float4 i_edgey_uv0 : TEXCOORD2;"
+			"float4 i_uv1_usdat : TEXCOORD3;"
+		"};"
+		"struct VS_OUTPUT {"
+			"float4 position : POSITION;"
+			"float4 diffuse : COLOR0;"
+			"float2 texCoord : TEXCOORD0;"
+		"};"
+
+		"VS_OUTPUT mainVS(VS_INPUT inVs) {"
+			"VS_OUTPUT outVs;"
+
+			"float2 pos = inVs.i_pos_edgex.xy"
+				" + inVs.position.x * inVs.i_pos_edgex.zw"
+				" + inVs.position.y * inVs.i_edgey_uv0.xy;"
+
+			"outVs.diffuse = inVs.diffuse * inVs.i_color;"
+			"outVs.texCoord = lerp(inVs.i_edgey_uv0.zw, inVs.i_uv1_usdat.xy, inVs.position.xy);"
+			"outVs.position = mul(float4(pos, 0.0f, 1.0f), g_mViewProj);"
+			"outVs.position.z = 1.0f;"
+
+			"return outVs;"
+		"}"
+
+		"float4 mainPS(VS_OUTPUT inPs) : COLOR0 {"
+			"return tex2D(samp0_, inPs.texCoord) * inPs.diffuse;"
+		"}"
+		"float4 mainPS_inv(VS_OUTPUT inPs) : COLOR0 {"
+			"float4 color = tex2D(samp0_, inPs.texCoord);"
+			"color.rgb = 1.0f - color.rgb;"
+
+			"return color * inPs.diffuse;"
+		"}"
+
+		"technique Render {"
+			"pass P0 {"
+				"VertexShader = compile vs_2_0 mainVS();"
+				"PixelShader = compile ps_2_0 mainPS();"
+			"}"
+		"}"
+		"technique RenderInv {"
+			"pass P0 {"
+				"VertexShader = compile vs_2_0 mainVS();"
+				"PixelShader = compile ps_2_0 mainPS_inv();"
+			"}"
+		"}";
+
 	//*******************************************************************
 	//RenderShaderLibrary
 	//*******************************************************************
@@ -439,7 +499,8 @@ namespace directx {
 				std::make_pair(&ShaderSource::sourceHwInstance2D_, &ShaderSource::nameHwInstance2D_),
 				std::make_pair(&ShaderSource::sourceHwInstance3D_, &ShaderSource::nameHwInstance3D_),
 				std::make_pair(&ShaderSource::sourceIntersectVisual1_, &ShaderSource::nameIntersectVisual1_),
-				std::make_pair(&ShaderSource::sourceIntersectVisual2_, &ShaderSource::nameIntersectVisual2_)
+				std::make_pair(&ShaderSource::sourceIntersectVisual2_, &ShaderSource::nameIntersectVisual2_),
+				std::make_pair(&ShaderSource::sourceShotBatch_, &ShaderSource::nameShotBatch_)
 			};
 			listEffect_.resize(listCreate.size(), nullptr);
 			for (size_t iEff = 0U; iEff < listCreate.size(); ++iEff) {
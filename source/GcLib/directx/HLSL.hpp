@@ -24,6 +24,9 @@ namespace directx {
 
 		static const std::string nameIntersectVisual2_;
 		static const std::string sourceIntersectVisual2_;
+
+		static const std::string nameShotBatch_;
+		static const std::string sourceShotBatch_;
 	};
 	
 	class RenderShaderLibrary {
@@ -46,6 +49,7 @@ namespace directx {
 		ID3DXEffect* GetInstancing3DShader() { return listEffect_[2]; }
 		ID3DXEffect* GetIntersectVisualShader1() { return listEffect_[3]; }
 		ID3DXEffect* GetIntersectVisualShader2() { return listEffect_[4]; }
+		ID3DXEffect* GetShotBatchShader() { return listEffect_[5]; }
 		size_t GetShaderCount() const { return listEffect_.size(); }
 
 		IDirect3DVertexDeclaration9* GetVertexDeclarationTLX() { return listDeclaration_[0]; }
@@ -233,8 +233,14 @@ int64_t ScriptManager::_LoadScript(const std::wstring& path, shared_ptr<ManagedS
 
 	script->bBeginLoad_ = true;
 
-	script->SetSourceFromFile(path);
-	script->Compile();
+	if (script->futureCompile_.valid()) {
+		//Rethrows the compile error, if any
+		script->futureCompile_.get();
+	}
+	else {
+		script->SetSourceFromFile(path);
+		script->Compile();
+	}
 
 	std::map<std::string, script_block*>::iterator itrEvent;
 	if (script->IsEventExists("Loading", itrEvent))
@@ -262,12 +268,23 @@ shared_ptr<ManagedScript> ScriptManager::LoadScript(
 	this->LoadScript(path, script);
 	return script;
 }
+void ScriptManager::CompileScriptAsync(const std::wstring& path, shared_ptr<ManagedScript> script) {
+	if (script->futureCompile_.valid()) return;
+
+	//The script waits for the task before it's destroyed
+	ManagedScript* pScript = script.get();
+	script->futureCompile_ = FileManager::GetBase()->AddLoadWorkerTask([pScript, path]() {
+		pScript->SetSourceFromFile(path);
+		pScript->Compile();
+	});
+}
 int64_t ScriptManager::LoadScriptInThread(const std::wstring& path, shared_ptr<ManagedScript> script) {
 	int64_t res = 0;
 	{
 		Lock lock(lock_);
 
 		script->SetPath(path);
+		CompileScriptAsync(path, script);
 
 		res = script->GetScriptID();
 		mapScriptLoad_[res] = script;
@@ -421,6 +438,9 @@ ManagedScript::ManagedScript() {
 	listValueEventSize_ = 0;
 }
 ManagedScript::~ManagedScript() {
+	if (futureCompile_.valid())
+		futureCompile_.wait();
+
 	//listValueEvent_ shouldn't be delete'd, that's the job of whatever was calling RequestEvent,
 	//	doing so will cause a memory corruption + crash if there was a script error in Run().
 
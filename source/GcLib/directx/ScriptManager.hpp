@@ -75,6 +75,9 @@ namespace directx {
 		shared_ptr<ManagedScript> LoadScript(
 			shared_ptr<ScriptManager> manager, const std::wstring& path, int type);
 
+		//Compiles the script on a load worker, the next LoadScript of it waits for the result
+		void CompileScriptAsync(const std::wstring& path, shared_ptr<ManagedScript> script);
+
 		int64_t LoadScriptInThread(const std::wstring& path, shared_ptr<ManagedScript> script);
 		shared_ptr<ManagedScript> LoadScriptInThread(
 			shared_ptr<ScriptManager> manager, const std::wstring& path, int type);
@@ -121,6 +124,7 @@ namespace directx {
 
 		std::atomic_bool bBeginLoad_;
 		std::atomic_bool bLoad_;
+		std::future<void> futureCompile_;
 
 		int typeScript_;
 		shared_ptr<ManagedScriptParameter> scriptParam_;
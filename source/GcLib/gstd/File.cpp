@@ -410,6 +410,15 @@ bool FileManager::Initialize() {
 #if defined(DNH_PROJ_EXECUTOR)
 	threadLoad_ = shared_ptr<LoadThread>(new LoadThread());
 	threadLoad_->Start();
+
+	{
+		size_t countCore = std::max(std::thread::hardware_concurrency(), 2U);
+		size_t countWorker = std::min<size_t>(countCore - 1, 4);
+		for (size_t i = 0; i < countWorker; ++i) {
+			listThreadWorker_.push_back(make_unique<LoadWorkerThread>(this));
+			listThreadWorker_.back()->Start();
+		}
+	}
 #endif
 
 	return true;
@@ -425,6 +434,17 @@ void FileManager::EndLoadThread() {
 		threadLoad_->Join();
 		threadLoad_ = nullptr;
 	}
+
+	//Pending worker tasks are abandoned
+	for (auto& thread : listThreadWorker_)
+		thread->Stop();
+	for (auto& thread : listThreadWorker_)
+		thread->Join();
+	{
+		Lock lock(lockWorkerTask_);
+		listThreadWorker_.clear();
+		listWorkerTask_.clear();
+	}
 }
 
 bool FileManager::AddArchiveFile(const std::wstring& archivePath, size_t readOff) {
@@ -675,6 +695,45 @@ void FileManager::WaitForThreadLoadComplete() {
 	while (!threadLoad_->IsThreadLoadComplete())
 		::Sleep(1);
 }
+std::future<void> FileManager::AddLoadWorkerTask(std::function<void()> task) {
+	std::packaged_task<void()> packagedTask(MOVE(task));
+	std::future<void> res = packagedTask.get_future();
+	{
+		Lock lock(lockWorkerTask_);
+		if (listThreadWorker_.size() > 0) {
+			listWorkerTask_.push_back(MOVE(packagedTask));
+			signalWorkerTask_.SetSignal();
+			return res;
+		}
+	}
+
+	//No workers, run it here
+	packagedTask();
+	return res;
+}
+
+//FileManager::LoadWorkerThread
+FileManager::LoadWorkerThread::LoadWorkerThread(FileManager* manager) {
+	manager_ = manager;
+}
+FileManager::LoadWorkerThread::~LoadWorkerThread() {}
+void FileManager::LoadWorkerThread::_Run() {
+	while (this->GetStatus() == RUN) {
+		std::packaged_task<void()> task;
+		{
+			Lock lock(manager_->lockWorkerTask_);
+			if (manager_->listWorkerTask_.size() > 0) {
+				task = MOVE(manager_->listWorkerTask_.front());
+				manager_->listWorkerTask_.pop_front();
+			}
+		}
+
+		if (task.valid())
+			task();
+		else
+			manager_->signalWorkerTask_.Wait(10);
+	}
+}
 
 //FileManager::LoadThread
 FileManager::LoadThread::LoadThread() {}
@@ -202,6 +202,7 @@ namespace gstd {
 #if defined(DNH_PROJ_EXECUTOR)
 		class LoadObject;
 		class LoadThread;
+		class LoadWorkerThread;
 		class LoadThreadListener;
 		class LoadThreadEvent;
 #endif
@@ -212,6 +213,12 @@ namespace gstd {
 		gstd::CriticalSection lock_;
 #if defined(DNH_PROJ_EXECUTOR)
 		shared_ptr<LoadThread> threadLoad_;
+
+		//Independent load tasks, like compiling scripts, are spread over these
+		std::vector<unique_ptr<LoadWorkerThread>> listThreadWorker_;
+		gstd::CriticalSection lockWorkerTask_;
+		gstd::ThreadSignal signalWorkerTask_;
+		std::list<std::packaged_task<void()>> listWorkerTask_;
 #endif
 
 #if defined(DNH_PROJ_EXECUTOR) || defined(DNH_PROJ_FILEARCHIVER)
@@ -242,6 +249,8 @@ namespace gstd {
 		void RemoveLoadThreadListener(FileManager::LoadThreadListener* listener);
 		void WaitForThreadLoadComplete();
 
+		std::future<void> AddLoadWorkerTask(std::function<void()> task);
+
 		bool AddArchiveFile(const std::wstring& archivePath, size_t readOff);
 		bool RemoveArchiveFile(const std::wstring& archivePath);
 
@@ -291,6 +300,15 @@ namespace gstd {
 		void RemoveListener(FileManager::LoadThreadListener* listener);
 	};
 
+	class FileManager::LoadWorkerThread : public Thread {
+		FileManager* manager_;
+	protected:
+		virtual void _Run();
+	public:
+		LoadWorkerThread(FileManager* manager);
+		virtual ~LoadWorkerThread();
+	};
+
 	class FileManager::LoadThreadListener {
 	public:
 		virtual ~LoadThreadListener() {}
@@ -993,6 +993,50 @@ std::wstring PathProperty::GetUnique(const std::wstring& srcPath) {
 	return ReplaceYenToSlash(p);
 }
 
+//*******************************************************************
+//SlabAllocator
+//*******************************************************************
+SlabAllocator::SlabAllocator(size_t sizeBlock, size_t countBlockPerSlab) {
+	sizeBlock_ = GetAlignedSize(sizeBlock);
+	countBlockPerSlab_ = std::max<size_t>(countBlockPerSlab, 1);
+	pFreeHead_ = nullptr;
+	countUsed_ = 0;
+
+	bReleased_ = false;
+}
+void* SlabAllocator::Allocate() {
+	if (pFreeHead_ == nullptr) {
+		listSlab_.push_back(make_unique<uint8_t[]>(sizeBlock_ * countBlockPerSlab_));
+		uint8_t* pSlab = listSlab_.back().get();
+
+		//Thread the new blocks into the free list, lowest address first
+		for (size_t i = countBlockPerSlab_; i > 0; --i) {
+			void* pBlock = pSlab + (i - 1) * sizeBlock_;
+			*reinterpret_cast<void**>(pBlock) = pFreeHead_;
+			pFreeHead_ = pBlock;
+		}
+	}
+
+	void* res = pFreeHead_;
+	pFreeHead_ = *reinterpret_cast<void**>(res);
+	++countUsed_;
+	return res;
+}
+void SlabAllocator::Free(void* ptr) {
+	if (ptr == nullptr) return;
+	*reinterpret_cast<void**>(ptr) = pFreeHead_;
+	pFreeHead_ = ptr;
+	--countUsed_;
+
+	if (bReleased_ && countUsed_ == 0)
+		delete this;
+}
+void SlabAllocator::Release() {
+	bReleased_ = true;
+	if (countUsed_ == 0)
+		delete this;
+}
+
 #if defined(DNH_PROJ_EXECUTOR) || defined(DNH_PROJ_CONFIG)
 //*******************************************************************
 //Scanner
@@ -8,6 +8,7 @@
 #include "GstdConstant.hpp"
 
 #include "CpuInformation.hpp"
+#include "Thread.hpp"
 
 namespace gstd {
 	//================================================================
@@ -49,31 +50,51 @@ namespace gstd {
 
 	//================================================================
 	//ThreadUtility
-	template<class F>
-	static void ParallelFor(size_t countLoop, F&& func) {
+	static inline size_t GetParallelChunkCount(size_t countLoop) {
 		size_t countCore = std::max(std::thread::hardware_concurrency(), 1U);
+		return (countCore > 1 && countLoop >= countCore * 64) ? countCore : 1U;
+	}
 
-		if (countCore > 1 && countLoop >= countCore * 64) {
-			std::vector<std::future<void>> workers;
-			workers.reserve(countCore);
+	//Splits [0, countLoop) into GetParallelChunkCount(countLoop) contiguous chunks in ascending order,
+	//	func(iChunk, begin, end) is called once for each chunk
+	template<class F>
+	static void ParallelForChunk(size_t countLoop, F&& func) {
+		size_t countChunk = GetParallelChunkCount(countLoop);
 
-			auto coreTask = [&](size_t id) {
-				const size_t begin = countLoop / countCore * id + std::min(countLoop % countCore, id);
-				const size_t end = countLoop / countCore * (id + 1U) + std::min(countLoop % countCore, id + 1U);
+		if (countChunk > 1) {
+			JobSystem::GetBase()->Run(countChunk, [&](size_t id) {
+				const size_t begin = countLoop / countChunk * id + std::min(countLoop % countChunk, id);
+				const size_t end = countLoop / countChunk * (id + 1U) + std::min(countLoop % countChunk, id + 1U);
+				func(id, begin, end);
+			});
+		}
+		else {
+			func(0U, 0U, countLoop);
+		}
+	}
+	//Splits [0, countLoop) into chunks of countGrain iterations, func(begin, end) is called once for each chunk
+	template<class F>
+	static void ParallelForGrain(size_t countLoop, size_t countGrain, F&& func) {
+		countGrain = std::max<size_t>(countGrain, 1U);
+		size_t countChunk = (countLoop + countGrain - 1) / countGrain;
 
+		JobSystem::GetBase()->Run(countChunk, [&](size_t id) {
+			func(id * countGrain, std::min(countLoop, (id + 1U) * countGrain));
+		});
+	}
+	template<class F>
+	static void ParallelFor(size_t countLoop, F&& func) {
+		//Finer chunks than ParallelForChunk so that threads done early can take over the rest
+		size_t countChunk = GetParallelChunkCount(countLoop);
+		if (countChunk > 1) {
+			ParallelForGrain(countLoop, countLoop / (countChunk * 4U) + 1U, [&](size_t begin, size_t end) {
 				for (size_t i = begin; i < end; ++i)
 					func(i);
-			};
-
-			for (size_t iCore = 0; iCore < countCore; ++iCore)
-				workers.emplace_back(std::async(std::launch::async | std::launch::deferred, coreTask, iCore));
-			for (const auto& worker : workers)
-				worker.wait();
+			});
 		}
 		else {
-			for (size_t i = 0; i < countLoop; ++i) {
+			for (size_t i = 0; i < countLoop; ++i)
 				func(i);
-			}
 		}
 	}
 
@@ -639,6 +660,42 @@ namespace gstd {
 		}
 	};
 
+	//================================================================
+	//SlabAllocator
+	//Fixed-size blocks carved out of large slabs, freed blocks are reused through an intrusive free list.
+	//	Not thread-safe. Slabs are only returned to the heap when the allocator is destroyed.
+	class SlabAllocator : public ref_count_pool {
+		size_t sizeBlock_;
+		size_t countBlockPerSlab_;
+		std::vector<unique_ptr<uint8_t[]>> listSlab_;
+
+		void* pFreeHead_;
+		size_t countUsed_;
+
+		bool bReleased_;
+	public:
+		SlabAllocator(size_t sizeBlock, size_t countBlockPerSlab);
+
+		void* Allocate();
+		void Free(void* ptr);
+
+		//For allocators created with new whose blocks may outlive the owner, e.g. through weak references.
+		//	Deletes the allocator now if no block is in use, otherwise when the last one is freed.
+		void Release();
+
+		virtual void* AllocateBlock() { return Allocate(); }
+		virtual void FreeBlock(void* pBlock) noexcept { Free(pBlock); }
+
+		size_t GetBlockSize() const { return sizeBlock_; }
+		size_t GetUsedCount() const { return countUsed_; }
+		size_t GetCapacity() const { return listSlab_.size() * countBlockPerSlab_; }
+
+		static constexpr size_t GetAlignedSize(size_t size) {
+			constexpr size_t ALIGN = alignof(std::max_align_t);
+			return (std::max(size, sizeof(void*)) + (ALIGN - 1)) & ~(ALIGN - 1);
+		}
+	};
+
 #if defined(DNH_PROJ_EXECUTOR) || defined(DNH_PROJ_CONFIG)
 	//================================================================
 	//Scanner
@@ -213,6 +213,10 @@ parser::symbol* parser::scope_t::singular_insert(const std::string& name, const
 	return &(this->insert(std::make_pair(name, s))->second);
 }
 
+const std::vector<function>& parser::get_base_operations() {
+	return base_operations;
+}
+
 parser::parser(script_engine* e, script_scanner* s) {
 	engine = e;
 	lexer_main = s;
@@ -1706,9 +1710,9 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 				"\"in\" or a colon is required.\r\n");
 			state->advance();
 
-			bool bMakeArrayUnique = true;
+			bool bRefArray = false;
 			if (state->next() == token_kind::tk_decl_mod_ref) {
-				bMakeArrayUnique = false;
+				bRefArray = true;
 				state->advance();
 			}
 
@@ -1717,8 +1721,18 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 
 			//The array
 			parse_expression(block, state);
-			if (bMakeArrayUnique)
-				state->AddCode(block, code(command_kind::pc_make_unique, 0));
+
+			//Arrays are copy-on-write, so the loop normally iterates over a snapshot.
+			//	With "ref" on a variable, loop over a pointer to it instead, so that
+			//	modifications made inside the loop body are still visited.
+			//	Any other expression has no storage to follow, and is rejected rather than silently copied.
+			if (bRefArray) {
+				code* pCodeArray = &block->codes.back();
+				parser_assert(state, state->ip == ip_var_format + 2
+					&& pCodeArray->GetOp() == command_kind::pc_push_variable,
+					"\"ref\" in a for-each loop can only be used on an array variable.\r\n");
+				pCodeArray->SetOp(command_kind::pc_push_variable2);
+			}
 
 			parser_assert(state, state->next() == token_kind::tk_close_par, "\")\" is required.\r\n");
 			state->advance();
@@ -2712,4 +2726,112 @@ void parser::scan_final(script_block* block, parser_state_t* state) {
 		parser_assert(itr->GetLine(), itr->GetOp() != command_kind::pc_loop_continue,
 			"\"continue\" may only be used inside a loop.");
 	}
+
+	fuse_superinstructions(block);
+}
+/* Fuses hot instruction sequences into superinstructions, e.g.
+ *		pc_push_variable	a
+ *		pc_push_value		1
+ *		pc_inline_add
+ *		pc_copy_assign		b
+ * into
+ *		pc_fused_op_assign_vc	a
+ *		(pc_push_value		1)
+ *		(pc_inline_add)
+ *		(pc_copy_assign		b)
+ * Only the first code is rewritten; the header skips over the rest at runtime.
+ * As the operand codes are left intact, a jump landing inside a fused sequence still runs the original code.
+ */
+void parser::fuse_superinstructions(script_block* block) {
+	auto IsArithmetic = [](command_kind c) {
+		switch (c) {
+		case command_kind::pc_inline_add:
+		case command_kind::pc_inline_sub:
+		case command_kind::pc_inline_mul:
+		case command_kind::pc_inline_div:
+		case command_kind::pc_inline_fdiv:
+		case command_kind::pc_inline_mod:
+		case command_kind::pc_inline_pow:
+			return true;
+		}
+		return false;
+	};
+	auto IsComparison = [](command_kind c) {
+		switch (c) {
+		case command_kind::pc_inline_cmp_e:
+		case command_kind::pc_inline_cmp_g:
+		case command_kind::pc_inline_cmp_ge:
+		case command_kind::pc_inline_cmp_l:
+		case command_kind::pc_inline_cmp_le:
+		case command_kind::pc_inline_cmp_ne:
+			return true;
+		}
+		return false;
+	};
+	auto IsPoppingJump = [](command_kind c) {
+		return c == command_kind::pc_jump_if || c == command_kind::pc_jump_if_not;
+	};
+
+	std::vector<code>& codes = block->codes;
+	for (size_t i = 0; i < codes.size(); ++i) {
+		code* c = &codes[i];
+		size_t remain = codes.size() - i;
+
+		switch (c->GetOp()) {
+		case command_kind::pc_push_variable:
+		{
+			if (remain < 3) break;
+
+			command_kind opRhs = c[1].GetOp();
+			command_kind opBin = c[2].GetOp();
+			if (opRhs != command_kind::pc_push_value && opRhs != command_kind::pc_push_variable)
+				break;
+			if (!IsArithmetic(opBin) && !IsComparison(opBin))
+				break;
+
+			bool bConst = opRhs == command_kind::pc_push_value;
+			command_kind opTail = remain >= 4 ? c[3].GetOp() : command_kind::pc_nop;
+
+			if (IsArithmetic(opBin) && opTail == command_kind::pc_copy_assign) {
+				c->SetOp(bConst ? command_kind::pc_fused_op_assign_vc : command_kind::pc_fused_op_assign_vv);
+				i += 3;
+			}
+			else if (IsComparison(opBin) && IsPoppingJump(opTail)) {
+				c->SetOp(bConst ? command_kind::pc_fused_cmp_jump_vc : command_kind::pc_fused_cmp_jump_vv);
+				i += 3;
+			}
+			else {
+				c->SetOp(bConst ? command_kind::pc_fused_op_vc : command_kind::pc_fused_op_vv);
+				i += 2;
+			}
+			break;
+		}
+		case command_kind::pc_inline_cmp_e:
+		case command_kind::pc_inline_cmp_g:
+		case command_kind::pc_inline_cmp_ge:
+		case command_kind::pc_inline_cmp_l:
+		case command_kind::pc_inline_cmp_le:
+		case command_kind::pc_inline_cmp_ne:
+			if (remain >= 2 && IsPoppingJump(c[1].GetOp())) {
+				c->arg0 = (uint32_t)c->GetOp();
+				c->SetOp(command_kind::pc_fused_cmp_jump);
+				i += 1;
+			}
+			break;
+		case command_kind::pc_loop_count:
+			if (remain >= 2 && c[1].GetOp() == command_kind::pc_jump_if_not) {
+				c->SetOp(command_kind::pc_fused_loop_count_jump);
+				i += 1;
+			}
+			break;
+		case command_kind::pc_loop_ascent:
+		case command_kind::pc_loop_descent:
+			if (remain >= 2 && c[1].GetOp() == command_kind::pc_jump_if) {
+				c->arg0 = (uint32_t)c->GetOp();
+				c->SetOp(command_kind::pc_fused_loop_range_jump);
+				i += 1;
+			}
+			break;
+		}
+	}
 }
@@ -104,8 +104,28 @@ namespace gstd {
 		pc_inline_index_array2,		//Push ({esp-1}[{esp-0}]) to stack
 		pc_inline_length_array,		//Push length({esp-0}) to stack
 
+		//------------------------------------------------------------------------
+		//Superinstructions
+		//	Written over the first code of a fused sequence by parser::fuse_superinstructions.
+		//	The rest of the sequence is kept in place as operands and skipped over.
+		//------------------------------------------------------------------------
+		pc_fused_op_vc,				//Push ((variable=[arg0, arg1]) <op=[ip+2]> [ip+1].data) to stack
+		pc_fused_op_vv,				//Push ((variable=[arg0, arg1]) <op=[ip+2]> (variable=[ip+1])) to stack
+		pc_fused_op_assign_vc,		//pc_fused_op_vc, then copy the result to variable=[ip+3]
+		pc_fused_op_assign_vv,		//pc_fused_op_vv, then copy the result to variable=[ip+3]
+		pc_fused_cmp_jump_vc,		//pc_fused_op_vc with a comparison, then do the jump at [ip+3]
+		pc_fused_cmp_jump_vv,		//pc_fused_op_vv with a comparison, then do the jump at [ip+3]
+		pc_fused_cmp_jump,			//Compare {esp-1} and {esp-0} with (command_kind)[arg0], pop twice, then do the jump at [ip+1]
+		pc_fused_loop_count_jump,	//Jump to [ip+1].arg0 if ({esp-0} <= 0), else do (--{esp-0})
+		pc_fused_loop_range_jump,	//Do (command_kind)[arg0] on {esp-1} and {esp-0}, jump to [ip+1].arg0 if the loop has ended
+
+		_pc_count,				//Number of opcodes, not an instruction
+
 		pc_nop = (uint8_t)-1,	//No operation
 	};
+	//Version of the code the parser emits, part of the key of cached bytecode (see ScriptBytecodeCache).
+	//	Bump this whenever an opcode changes meaning or the parser emits different code for the same source.
+	constexpr uint32_t BYTECODE_VERSION = 2;
 	enum class block_kind : uint8_t {
 		bk_normal, bk_sub, bk_function, bk_microthread
 	};
@@ -118,6 +138,9 @@ namespace gstd {
 		dnh_func_callback_t func;
 		std::vector<code> codes;
 		block_kind kind;
+#ifdef __L_SCRIPT_THREADED_DISPATCH
+		std::vector<void*> dispatch;	//Handler address of each code, filled by script_machine on first run
+#endif
 
 		script_block(uint32_t level, block_kind kind);
 	};
@@ -279,6 +302,8 @@ namespace gstd {
 		parser(script_engine* e, script_scanner* s);
 		virtual ~parser() {}
 
+		static const std::vector<function>& get_base_operations();
+
 		void load_functions(std::vector<function>* list_func);
 		void load_constants(std::vector<constant>* list_const);
 		void begin_parse();
@@ -328,6 +353,7 @@ namespace gstd {
 		void link_break_continue(script_block* block, parser_state_t* state, 
 			size_t ip_begin, size_t ip_end, size_t ip_break, size_t ip_continue);
 		void scan_final(script_block* block, parser_state_t* state);
+		void fuse_superinstructions(script_block* block);
 
 		inline static void parser_assert(bool expr, const std::wstring& error);
 		inline static void parser_assert(bool expr, const std::string& error);
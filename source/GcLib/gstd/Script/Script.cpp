@@ -37,6 +37,8 @@ script_type_manager::script_type_manager() {
 }
 
 type_data* script_type_manager::get_type(type_data* type) {
+	std::lock_guard<std::mutex> guard(lock);
+
 	auto itr = types.find(*type);
 	if (itr == types.end()) {
 		//No type found, insert and return the new type
@@ -56,6 +58,13 @@ type_data* script_type_manager::get_array_type(type_data* element) {
 //****************************************************************************
 //script_engine
 //****************************************************************************
+script_engine::script_engine() {
+	data = nullptr;
+	main_block = nullptr;
+
+	error = false;
+	error_line = -1;
+}
 script_engine::script_engine(const std::wstring& source, std::vector<function>* list_func, std::vector<constant>* list_const) {
 	init(source.data(), source.data() + source.size(), list_func, list_const);
 }
@@ -96,78 +105,130 @@ script_block* script_engine::new_block(int level, block_kind kind) {
 }
 
 //****************************************************************************
-//script_machine::environment
+//script_machine::env_allocator
 //****************************************************************************
 script_machine::env_allocator::env_allocator(script_machine* machine) : machine(machine) {
-	_alloc_more(1024);
+	free_environments = nullptr;
+	free_ref_blocks = nullptr;
+	_alloc_more();
 }
 script_machine::env_allocator::~env_allocator() {
 	// Must release all owned environment before destroying the allocator
-	environments.clear();
+	chunks.clear();
 }
 
-void script_machine::env_allocator::_alloc_more(size_t n) {
-	constexpr size_t MAX_N = std::numeric_limits<size_t>::max() / sizeof(value_type);
-
-	size_t before_size = environments.size();
+void script_machine::env_allocator::_alloc_more() {
+	std::vector<environment>& chunk = chunks.emplace_back();
+	chunk.reserve(CHUNK_SIZE);
 
-	if (before_size + n > MAX_N)
-		throw std::bad_array_new_length();
-
-	for (size_t i = 0; i < n; ++i) {
-		size_t index = before_size + i;
+	for (size_t i = 0; i < CHUNK_SIZE; ++i)
+		chunk.emplace_back(machine);
 
-		environment env(machine);
-		env._index = index;
-
-		environments.push_back(std::move(env));
-		free_environments.push_back(index);
+	//Link back to front so environments are handed out in address order
+	for (size_t i = CHUNK_SIZE; i-- > 0;) {
+		chunk[i]._next_free = free_environments;
+		free_environments = &chunk[i];
+	}
+}
+void script_machine::env_allocator::_alloc_more_ref_block() {
+	char* chunk = new char[REF_BLOCK_SIZE * CHUNK_SIZE];
+	chunksRefBlock.emplace_back(chunk);
+
+	for (size_t i = CHUNK_SIZE; i-- > 0;) {
+		void* block = chunk + i * REF_BLOCK_SIZE;
+		*(void**)block = free_ref_blocks;
+		free_ref_blocks = block;
 	}
 }
 
 script_machine::env_allocator::value_type* 
 script_machine::env_allocator::allocate(size_t n) {
-	if (free_environments.size() == 0) {
-		_alloc_more(1024);
-	}
+	if (free_environments == nullptr)
+		_alloc_more();
 
-	size_t free_index = free_environments.front();
-	free_environments.pop_front();
+	environment* res = free_environments;
+	free_environments = res->_next_free;
+	res->_next_free = nullptr;
 
-	return &environments[free_index];
+	return res;
 }
 void script_machine::env_allocator::deallocate(value_type* p, size_t n) noexcept {
 	for (size_t i = 0; i < n; ++i) {
 		value_type& env = p[i];
 
+		//Cleared, not freed, so the next user of this environment doesn't have to grow them again
 		env.variables.clear();
 		env.stack.clear();
+		env.display.clear();
+		env.sub = nullptr;
+
+		env._next_free = free_environments;
+		free_environments = &env;
+
+		//May free the rest of the chain
+		env.parent = nullptr;
+	}
+}
 
-		free_environments.push_back(env._index);
+void* script_machine::env_allocator::allocate_ref_block(size_t size) {
+	if (size > REF_BLOCK_SIZE)
+		return ::operator new(size);
+
+	if (free_ref_blocks == nullptr)
+		_alloc_more_ref_block();
+
+	void* res = free_ref_blocks;
+	free_ref_blocks = *(void**)res;
+	return res;
+}
+void script_machine::env_allocator::deallocate_ref_block(void* p, size_t size) noexcept {
+	if (size > REF_BLOCK_SIZE) {
+		::operator delete(p);
+		return;
 	}
+
+	*(void**)p = free_ref_blocks;
+	free_ref_blocks = p;
 }
 
 //****************************************************************************
 //script_machine::environment
 //****************************************************************************
 script_machine::environment::environment(script_machine* machine) : 
-	machine(machine), _index(-1),
+	machine(machine), _next_free(nullptr),
 	parent(nullptr),
 	sub(nullptr), ip(0),
 	hasResult(false), waitCount(0) {}
 
-script_machine::environment::environment(const environment& base_from, sptr<environment> parent, script_block* sub) :
-	environment(base_from.machine)
-{
-	_index = base_from._index;
+void script_machine::environment::init(sptr<environment> parent, script_block* sub) {
 	this->parent = parent;
 	this->sub = sub;
+	ip = 0;
+	hasResult = false;
+	waitCount = 0;
+
+	display.clear();
+	if (sub != nullptr && parent != nullptr) {
+		uint32_t level = sub->level;
+		display.assign(level, nullptr);
+
+		const std::vector<environment*>& parentDisplay = parent->display;
+		size_t countShared = std::min<size_t>(level, parentDisplay.size());
+		std::copy(parentDisplay.begin(), parentDisplay.begin() + countShared, display.begin());
+
+		uint32_t levelParent = parent->sub->level;
+		if (levelParent < level)
+			display[levelParent] = parent.get();
+	}
 }
 
 //****************************************************************************
 //script_machine
 //****************************************************************************
-script_machine::script_machine(script_engine* engine) : engine(engine), allocator(this) {
+script_machine::script_machine(script_engine* engine) : engine(engine),
+	threads(nullptr), current_thread(nullptr), thread_count(0),
+	lap(0), free_threads(nullptr), allocator(this)
+{
 	reset();
 }
 script_machine::~script_machine() {
@@ -180,7 +241,7 @@ script_machine::env_ptr script_machine::get_new_environment() {
 
 	res.reset(pEnv, [this](environment* ptr) { 
 		allocator.deallocate(ptr, 1);
-	});
+	}, env_ref_allocator<environment>(&allocator));
 	return res;
 }
 
@@ -206,21 +267,115 @@ void script_machine::reset() {
 	resuming = false;
 
 	list_parent_environment.clear();
-	threads.clear();
-	current_thread_index = {};
+	for (script_thread* i = threads; i != nullptr;) {
+		script_thread* next = i->next;
+		_delete_thread(i);
+		i = next;
+	}
+	threads = nullptr;
+	current_thread = nullptr;
+	thread_count = 0;
+
+	lap = 0;
+	std::fill(std::begin(wait_wheel), std::end(wait_wheel), nullptr);
+}
+
+script_machine::script_thread* script_machine::_new_thread(env_ptr env) {
+	if (free_threads == nullptr) {
+		script_thread* chunk = new script_thread[THREAD_CHUNK_SIZE];
+		chunksThread.emplace_back(chunk);
+		for (size_t i = THREAD_CHUNK_SIZE; i-- > 0;) {
+			chunk[i].wait_next = free_threads;
+			free_threads = &chunk[i];
+		}
+	}
+
+	script_thread* res = free_threads;
+	free_threads = res->wait_next;
+
+	res->env = MOVE(env);
+	res->order = 0;
+	res->prev = res->next = nullptr;
+	res->run_prev = res->run_next = res;
+	res->wait_next = nullptr;
+	res->wake_lap = 0;
+
+	++thread_count;
+	return res;
+}
+void script_machine::_delete_thread(script_thread* thread) {
+	thread->env = nullptr;
+	thread->wait_next = free_threads;
+	free_threads = thread;
+
+	--thread_count;
+}
+void script_machine::_relabel_threads() {
+	uint64_t order = 0;
+	for (script_thread* i = threads; i != nullptr; i = i->next, order += THREAD_ORDER_STEP)
+		i->order = order;
+}
+void script_machine::_erase_thread(script_thread* thread) {
+	if (thread->prev) thread->prev->next = thread->next;
+	if (thread->next) thread->next->prev = thread->prev;
+
+	thread->run_prev->run_next = thread->run_next;
+	thread->run_next->run_prev = thread->run_prev;
+
+	_delete_thread(thread);
+}
+void script_machine::_park_thread(script_thread* thread, int waitCount) {
+	//Skipped for the next waitCount laps, as if it were visited and counted down each time
+	//	Its own links are left as they are, so yielding from it still moves to its predecessor
+	thread->run_prev->run_next = thread->run_next;
+	thread->run_next->run_prev = thread->run_prev;
+
+	thread->wake_lap = lap + 1 + waitCount;
+	script_thread*& bucket = wait_wheel[thread->wake_lap % WAIT_WHEEL_SIZE];
+	thread->wait_next = bucket;
+	bucket = thread;
+}
+void script_machine::_wake_threads() {
+	script_thread** pLink = &wait_wheel[lap % WAIT_WHEEL_SIZE];
+	while (script_thread* thread = *pLink) {
+		if (thread->wake_lap == lap) {
+			*pLink = thread->wait_next;
+			thread->wait_next = nullptr;
+			list_woken.push_back(thread);
+		}
+		else pLink = &thread->wait_next;	//Due in a later round of the wheel
+	}
+	if (list_woken.empty()) return;
+
+	//Merge back into the runnable ring at their original positions
+	std::sort(list_woken.begin(), list_woken.end(),
+		[](script_thread* a, script_thread* b) { return a->order < b->order; });
+
+	script_thread* pos = threads;
+	for (script_thread* thread : list_woken) {
+		while (pos->run_next != threads && pos->run_next->order < thread->order)
+			pos = pos->run_next;
+
+		thread->run_prev = pos;
+		thread->run_next = pos->run_next;
+		pos->run_next->run_prev = thread;
+		pos->run_next = thread;
+		pos = thread;
+	}
+	list_woken.clear();
 }
 void script_machine::run() {
 	if (bTerminate) return;
 
-	if (threads.size() == 0) {
+	if (threads == nullptr) {
 		error_line = -1;
 
 		env_ptr mainEnv = get_new_environment();
-		*mainEnv = environment(*mainEnv, nullptr, engine->main_block);
+		mainEnv->init(nullptr, engine->main_block);
 
-		threads.push_back(mainEnv);
+		threads = _new_thread(mainEnv);
 
-		current_thread_index = threads.begin();
+		current_thread = threads;
 
 		finished = false;
 		stopped = false;
@@ -253,17 +408,17 @@ void script_machine::call(std::map<std::string, script_block*>::iterator event_i
 
 void script_machine::interrupt(script_block* sub) {
 	// Save current thread
-	auto prev_thread = current_thread_index;
-	current_thread_index = threads.begin();
+	script_thread* prev_thread = current_thread;
+	current_thread = threads;
 
 	// Replace current thread with the interrupt
 	{
-		env_ptr env_first = *current_thread_index;
+		env_ptr env_first = current_thread->env;
 
 		env_ptr new_env = get_new_environment();
-		*new_env = environment(*new_env, env_first, sub);
+		new_env->init(env_first, sub);
 
-		*current_thread_index = new_env;
+		current_thread->env = new_env;
 
 		finished = false;
 
@@ -275,32 +430,96 @@ void script_machine::interrupt(script_block* sub) {
 	}
 
 	// Resume previous thread
-	current_thread_index = prev_thread;
+	current_thread = prev_thread;
 }
 script_machine::env_ptr script_machine::add_thread(script_block* sub) {
 	env_ptr e = get_new_environment();
-	*e = environment(*e, *current_thread_index, sub);
+	e->init(current_thread->env, sub);
+
+	//Goes right after the current thread and runs at once, yielding back to the caller
+	script_thread* pos = current_thread;
+	script_thread* next = pos->next;
+	if ((next ? next->order : std::numeric_limits<uint64_t>::max()) - pos->order < 2) {
+		_relabel_threads();
+	}
+
+	script_thread* thread = _new_thread(e);
+	if (next)
+		thread->order = pos->order + (next->order - pos->order) / 2;
+	else
+		thread->order = pos->order + std::min(THREAD_ORDER_STEP, (std::numeric_limits<uint64_t>::max() - pos->order) / 2);
+
+	thread->prev = pos;
+	thread->next = next;
+	pos->next = thread;
+	if (next) next->prev = thread;
 
-	threads.insert(++current_thread_index, e);
-	--current_thread_index;
+	thread->run_prev = pos;
+	thread->run_next = pos->run_next;
+	pos->run_next->run_prev = thread;
+	pos->run_next = thread;
 
+	current_thread = thread;
 	return e;
 }
 script_machine::env_ptr script_machine::add_child_block(script_block* sub) {
 	env_ptr e = get_new_environment();
-	*e = environment(*e, *current_thread_index, sub);
+	e->init(current_thread->env, sub);
+
+	return current_thread->env = MOVE(e);
+}
+
+//Evaluates the binary operation of a fused superinstruction
+static value _fused_binary_operate(script_machine* machine, command_kind op, const value* args) {
+#define DEF_CASE(cmd, fn) case cmd: return BaseFunction::fn(machine, 2, args);
+	switch (op) {
+		DEF_CASE(command_kind::pc_inline_add, add);
+		DEF_CASE(command_kind::pc_inline_sub, subtract);
+		DEF_CASE(command_kind::pc_inline_mul, multiply);
+		DEF_CASE(command_kind::pc_inline_div, divide);
+		DEF_CASE(command_kind::pc_inline_fdiv, fdivide);
+		DEF_CASE(command_kind::pc_inline_mod, remainder_);
+		DEF_CASE(command_kind::pc_inline_pow, power);
+	}
+#undef DEF_CASE
+
+	int cmp_r = BaseFunction::compare(machine, 2, args).as_int();
+	bool cmp_rb = false;
+
+#define DEF_CASE(cmd, expr) case cmd: cmp_rb = (expr); break;
+	switch (op) {
+		DEF_CASE(command_kind::pc_inline_cmp_e, cmp_r == 0);
+		DEF_CASE(command_kind::pc_inline_cmp_g, cmp_r > 0);
+		DEF_CASE(command_kind::pc_inline_cmp_ge, cmp_r >= 0);
+		DEF_CASE(command_kind::pc_inline_cmp_l, cmp_r < 0);
+		DEF_CASE(command_kind::pc_inline_cmp_le, cmp_r <= 0);
+		DEF_CASE(command_kind::pc_inline_cmp_ne, cmp_r != 0);
+	}
+#undef DEF_CASE
 
-	return *current_thread_index = MOVE(e);
+	return value(script_type_manager::get_boolean_type(), cmp_rb);
 }
 
+//Threaded dispatch jumps straight to the handler labels inside the switch
+#ifdef __L_SCRIPT_THREADED_DISPATCH
+#define VM_CASE(_op) case command_kind::_op: lab_##_op:
+#define VM_DEFAULT default: lab_default:
+#else
+#define VM_CASE(_op) case command_kind::_op:
+#define VM_DEFAULT default:
+#endif
+
 void script_machine::run_code() {
-	if (threads.size() == 0) {
-		current_thread_index = {};
+	if (threads == nullptr) {
+		current_thread = nullptr;
 		return;
 	}
+
+	//The line is only recovered from the last executed code when needed
+	code* c = nullptr;
 	try {
 		while (!finished && !bTerminate) {
-			env_ptr current = *current_thread_index;
+			env_ptr current = current_thread->env;
 
 			if (current->waitCount > 0) {
 				--(current->waitCount);
@@ -324,13 +543,14 @@ void script_machine::run_code() {
 				}
 				else {
 					if (current->sub->kind == block_kind::bk_microthread) {
-						current_thread_index = threads.erase(current_thread_index);
-						yield();
+						script_thread* prev = current_thread->run_prev;
+						_erase_thread(current_thread);
+						current_thread = prev;
 					}
 					else {
 						if (current->hasResult && parent != nullptr)
 							parent->stack.push_back(current->variables[0]);
-						*current_thread_index = parent;
+						current_thread->env = parent;
 					}
 				}
 			}
@@ -338,30 +558,146 @@ void script_machine::run_code() {
 				auto& stack = current->stack;
 				auto& variables = current->variables;
 
-				code* c = &(current->sub->codes[current->ip]);
-				error_line = c->GetLine();
-				++(current->ip);
+				code* codes = current->sub->codes.data();
+#ifdef __L_SCRIPT_THREADED_DISPATCH
+				//Pre-decode the block into handler addresses on its first run
+				std::vector<void*>& dispatch = current->sub->dispatch;
+				if (dispatch.empty()) {
+					void* handlers[256];
+					std::fill(std::begin(handlers), std::end(handlers), &&lab_default);
+
+#define VM_LABEL(_op) handlers[(size_t)command_kind::_op] = &&lab_##_op
+					VM_LABEL(pc_wait);
+					VM_LABEL(pc_yield);
+					VM_LABEL(pc_var_alloc);
+					VM_LABEL(pc_var_format);
+					VM_LABEL(pc_pop);
+					VM_LABEL(pc_push_value);
+					VM_LABEL(pc_push_variable);
+					VM_LABEL(pc_push_variable2);
+					VM_LABEL(pc_dup_n);
+					VM_LABEL(pc_swap);
+					VM_LABEL(pc_load_ptr);
+					VM_LABEL(pc_unload_ptr);
+					VM_LABEL(pc_make_unique);
+					VM_LABEL(pc_jump);
+					VM_LABEL(pc_jump_if);
+					VM_LABEL(pc_jump_if_not);
+					VM_LABEL(pc_jump_if_nopop);
+					VM_LABEL(pc_jump_if_not_nopop);
+					VM_LABEL(pc_copy_assign);
+					VM_LABEL(pc_ref_assign);
+					VM_LABEL(pc_sub_return);
+					VM_LABEL(pc_call);
+					VM_LABEL(pc_call_and_push_result);
+					VM_LABEL(pc_compare_e);
+					VM_LABEL(pc_compare_g);
+					VM_LABEL(pc_compare_ge);
+					VM_LABEL(pc_compare_l);
+					VM_LABEL(pc_compare_le);
+					VM_LABEL(pc_compare_ne);
+					VM_LABEL(pc_loop_ascent);
+					VM_LABEL(pc_loop_descent);
+					VM_LABEL(pc_loop_count);
+					VM_LABEL(pc_loop_foreach);
+					VM_LABEL(pc_construct_array);
+					VM_LABEL(pc_inline_inc);
+					VM_LABEL(pc_inline_dec);
+					VM_LABEL(pc_inline_add_asi);
+					VM_LABEL(pc_inline_sub_asi);
+					VM_LABEL(pc_inline_mul_asi);
+					VM_LABEL(pc_inline_div_asi);
+					VM_LABEL(pc_inline_fdiv_asi);
+					VM_LABEL(pc_inline_mod_asi);
+					VM_LABEL(pc_inline_pow_asi);
+					VM_LABEL(pc_inline_cat_asi);
+					VM_LABEL(pc_inline_neg);
+					VM_LABEL(pc_inline_not);
+					VM_LABEL(pc_inline_abs);
+					VM_LABEL(pc_inline_add);
+					VM_LABEL(pc_inline_sub);
+					VM_LABEL(pc_inline_mul);
+					VM_LABEL(pc_inline_div);
+					VM_LABEL(pc_inline_fdiv);
+					VM_LABEL(pc_inline_mod);
+					VM_LABEL(pc_inline_pow);
+					VM_LABEL(pc_inline_app);
+					VM_LABEL(pc_inline_cat);
+					VM_LABEL(pc_inline_cmp_e);
+					VM_LABEL(pc_inline_cmp_g);
+					VM_LABEL(pc_inline_cmp_ge);
+					VM_LABEL(pc_inline_cmp_l);
+					VM_LABEL(pc_inline_cmp_le);
+					VM_LABEL(pc_inline_cmp_ne);
+					VM_LABEL(pc_inline_logic_and);
+					VM_LABEL(pc_inline_logic_or);
+					VM_LABEL(pc_inline_cast_var);
+					VM_LABEL(pc_inline_index_array);
+					VM_LABEL(pc_inline_index_array2);
+					VM_LABEL(pc_inline_length_array);
+					VM_LABEL(pc_fused_op_vc);
+					VM_LABEL(pc_fused_op_vv);
+					VM_LABEL(pc_fused_op_assign_vc);
+					VM_LABEL(pc_fused_op_assign_vv);
+					VM_LABEL(pc_fused_cmp_jump_vc);
+					VM_LABEL(pc_fused_cmp_jump_vv);
+					VM_LABEL(pc_fused_cmp_jump);
+					VM_LABEL(pc_fused_loop_count_jump);
+					VM_LABEL(pc_fused_loop_range_jump);
+#undef VM_LABEL
+
+					size_t countCodes = current->sub->codes.size();
+					dispatch.resize(countCodes + 1);
+					for (size_t i = 0; i < countCodes; ++i)
+						dispatch[i] = handlers[(size_t)codes[i].GetOp()];
+					dispatch[countCodes] = &&lab_end;		//Sentinel for running off the end of the block
+				}
+#else
+				size_t countCodes = current->sub->codes.size();
+#endif
 
-				command_kind opc = c->GetOp();
+				//Keep running the current environment until it yields, calls into another block, or ends
+lab_next:
+				if (finished) {
+					if (error) error_line = c->GetLine();
+					goto lab_leave;
+				}
+#ifdef __L_SCRIPT_THREADED_DISPATCH
+				c = codes + current->ip;
+				goto *dispatch[(current->ip)++];
+#else
+				if (current->ip >= countCodes)
+					goto lab_leave;
+				c = codes + current->ip;
+				++(current->ip);
+#endif
 
-				switch (opc) {
-				case command_kind::pc_wait:
+				switch (c->GetOp()) {
+				VM_CASE(pc_wait)
 				{
 					value* t = &stack.back();
 					current->waitCount = (int)t->as_int() - 1;
 					stack.pop_back();
 					if (current->waitCount < 0) break;
 
+					if (current->waitCount > 0 && current_thread != threads) {
+						//Sleeps off the main thread are parked in the wait wheel
+						_park_thread(current_thread, current->waitCount);
+						current->waitCount = 0;
+						yield();
+						goto lab_leave;
+					}
+
 					__fallthrough;
 				}
-				case command_kind::pc_yield:
+				VM_CASE(pc_yield)
 					yield();
-					break;
+					goto lab_leave;
 
-				case command_kind::pc_var_alloc:
+				VM_CASE(pc_var_alloc)
 					variables.resize(c->arg0);
 					break;
-				case command_kind::pc_var_format:
+				VM_CASE(pc_var_format)
 				{
 					for (size_t i = c->arg0; i < c->arg0 + c->arg1; ++i) {
 						if (i >= variables.capacity()) break;
@@ -370,17 +706,19 @@ void script_machine::run_code() {
 					break;
 				}
 
-				case command_kind::pc_pop:
+				VM_CASE(pc_pop)
 					for (int i = 0; i < c->arg0; ++i)
 						stack.pop_back();
 					break;
-				case command_kind::pc_push_value:
+				VM_CASE(pc_push_value)
 					stack.push_back(c->data);
 					break;
-				case command_kind::pc_push_variable:
-				case command_kind::pc_push_variable2:
+				VM_CASE(pc_push_variable)
+				VM_CASE(pc_push_variable2)
 				{
-					value* var = find_variable_symbol<false>(current, c, c->arg0, c->arg1);
+					command_kind opc = c->GetOp();
+
+					value* var = find_variable_symbol<false>(current.get(), c, c->arg0, c->arg1);
 					if (var == nullptr) break;
 
 					if (opc == command_kind::pc_push_variable)
@@ -390,7 +728,7 @@ void script_machine::run_code() {
 
 					break;
 				}
-				case command_kind::pc_dup_n:
+				VM_CASE(pc_dup_n)
 				{
 					if (c->arg0 >= stack.size()) break;
 					value* val = &stack.back() - c->arg0;
@@ -398,28 +736,28 @@ void script_machine::run_code() {
 					//stack.back().make_unique();
 					break;
 				}
-				case command_kind::pc_swap:
+				VM_CASE(pc_swap)
 				{
 					size_t len = stack.size();
 					if (len < 2) break;
 					std::swap(stack[len - 1], stack[len - 2]);
 					break;
 				}
-				case command_kind::pc_load_ptr:
+				VM_CASE(pc_load_ptr)
 				{
 					if (c->arg0 >= stack.size()) break;
 					value* val = &stack.back() - c->arg0;
 					stack.push_back(value(script_type_manager::get_ptr_type(), val));
 					break;
 				}
-				case command_kind::pc_unload_ptr:
+				VM_CASE(pc_unload_ptr)
 				{
 					value* val = &stack.back();
 					value* valAtPtr = val->as_ptr();
 					*val = *valAtPtr;
 					break;
 				}
-				case command_kind::pc_make_unique:
+				VM_CASE(pc_make_unique)
 				{
 					if (c->arg0 >= stack.size()) break;
 					value* val = &stack.back() - c->arg0;
@@ -429,12 +767,14 @@ void script_machine::run_code() {
 
 				//case command_kind::_pc_jump_target:
 				//	break;
-				case command_kind::pc_jump:
+				VM_CASE(pc_jump)
 					current->ip = c->arg0;
 					break;
-				case command_kind::pc_jump_if:
-				case command_kind::pc_jump_if_not:
+				VM_CASE(pc_jump_if)
+				VM_CASE(pc_jump_if_not)
 				{
+					command_kind opc = c->GetOp();
+
 					value* top = &stack.back();
 					bool bJE = opc == command_kind::pc_jump_if;
 					if ((bJE && top->as_boolean()) || (!bJE && !top->as_boolean()))
@@ -442,9 +782,11 @@ void script_machine::run_code() {
 					stack.pop_back();
 					break;
 				}
-				case command_kind::pc_jump_if_nopop:
-				case command_kind::pc_jump_if_not_nopop:
+				VM_CASE(pc_jump_if_nopop)
+				VM_CASE(pc_jump_if_not_nopop)
 				{
+					command_kind opc = c->GetOp();
+
 					value* top = &stack.back();
 					bool bJE = opc == command_kind::pc_jump_if_nopop;
 					if ((bJE && top->as_boolean()) || (!bJE && !top->as_boolean()))
@@ -452,11 +794,13 @@ void script_machine::run_code() {
 					break;
 				}
 
-				case command_kind::pc_copy_assign:
-				case command_kind::pc_ref_assign:
+				VM_CASE(pc_copy_assign)
+				VM_CASE(pc_ref_assign)
 				{
+					command_kind opc = c->GetOp();
+
 					if (opc == command_kind::pc_copy_assign) {
-						value* dest = find_variable_symbol<true>(current, c, c->arg0, c->arg1);
+						value* dest = find_variable_symbol<true>(current.get(), c, c->arg0, c->arg1);
 						value* src = &stack.back();
 
 						if (dest != nullptr && src != nullptr) {
@@ -465,7 +809,6 @@ void script_machine::run_code() {
 								type_data* prev_type = dest->get_type();
 
 								*dest = *src;
-								dest->make_unique();
 
 								if (prev_type && prev_type != src->get_type())
 									BaseFunction::_value_cast(dest, prev_type);
@@ -494,7 +837,7 @@ void script_machine::run_code() {
 					break;
 				}
 
-				case command_kind::pc_sub_return:
+				VM_CASE(pc_sub_return)
 					for (env_ptr i = current; i != nullptr; i = i->parent) {
 						i->ip = i->sub->codes.size();
 
@@ -503,9 +846,14 @@ void script_machine::run_code() {
 							break;
 					}
 					break;
-				case command_kind::pc_call:
-				case command_kind::pc_call_and_push_result:
+				VM_CASE(pc_call)
+				VM_CASE(pc_call_and_push_result)
 				{
+					command_kind opc = c->GetOp();
+
+					//Builtin functions may query the current line
+					error_line = c->GetLine();
+
 					//assert(current_stack.size() >= c->arguments);
 
 					if (stack.size() < c->arg1) {
@@ -592,16 +940,21 @@ void script_machine::run_code() {
 						_PassArgsFromStack(c->arg1, stack, e->stack);
 					}
 
+					//Entered a child block or got interrupted
+					if (current != current_thread->env)
+						goto lab_leave;
 					break;
 				}
 
-				case command_kind::pc_compare_e:
-				case command_kind::pc_compare_g:
-				case command_kind::pc_compare_ge:
-				case command_kind::pc_compare_l:
-				case command_kind::pc_compare_le:
-				case command_kind::pc_compare_ne:
+				VM_CASE(pc_compare_e)
+				VM_CASE(pc_compare_g)
+				VM_CASE(pc_compare_ge)
+				VM_CASE(pc_compare_l)
+				VM_CASE(pc_compare_le)
+				VM_CASE(pc_compare_ne)
 				{
+					command_kind opc = c->GetOp();
+
 					value* t = &stack.back();
 
 					int r = t->as_int();
@@ -632,9 +985,11 @@ void script_machine::run_code() {
 				}
 
 				// Loop commands
-				case command_kind::pc_loop_ascent:
-				case command_kind::pc_loop_descent:
+				VM_CASE(pc_loop_ascent)
+				VM_CASE(pc_loop_descent)
 				{
+					command_kind opc = c->GetOp();
+
 					value* cmp_arg = &stack.back() - 1;
 					value cmp_res = BaseFunction::compare(this, 2, cmp_arg);
 
@@ -645,7 +1000,7 @@ void script_machine::run_code() {
 					//stack.pop_back(2U);
 					break;
 				}
-				case command_kind::pc_loop_count:
+				VM_CASE(pc_loop_count)
 				{
 					value* i = &stack.back();
 
@@ -657,11 +1012,13 @@ void script_machine::run_code() {
 
 					break;
 				}
-				case command_kind::pc_loop_foreach:
+				VM_CASE(pc_loop_foreach)
 				{
-					// Stack: .... [array] [counter]
+					// Stack: .... [array or &array] [counter]
 					value* i = &stack.back();
 					value* src_array = i - 1;
+					if (src_array->get_type()->get_kind() == type_data::tk_pointer)
+						src_array = src_array->as_ptr();	//for each (... in ref arr), re-read the live variable
 
 					size_t index = i->as_int();
 					size_t arrSize = src_array->length_as_array();
@@ -671,16 +1028,17 @@ void script_machine::run_code() {
 						bStopLoop = true;
 					}
 					else {
-						stack.push_back(src_array->index_as_array(index));
-						//stack.back().make_unique();
+						//Advance the counter first, the push can reallocate the stack under i
 						i->set(i->get_type(), i->as_int() + 1LL);
+						stack.push_back(src_array->array_get_value(index));
+						//stack.back().make_unique();
 					}
 
 					stack.push_back(value(script_type_manager::get_boolean_type(), bStopLoop));
 					break;
 				}
 
-				case command_kind::pc_construct_array:
+				VM_CASE(pc_construct_array)
 				{
 					if (c->arg0 == 0U) {
 						stack.push_back(BaseFunction::_create_empty(script_type_manager::get_null_array_type()));
@@ -719,11 +1077,13 @@ void script_machine::run_code() {
 #define ARG1_GET_VAR(_PK)	(uint32_t)(((uint32_t)(_PK) & 0x000fffff))
 
 				// ----------------------------------Inline operations----------------------------------
-				case command_kind::pc_inline_inc:
-				case command_kind::pc_inline_dec:
+				VM_CASE(pc_inline_inc)
+				VM_CASE(pc_inline_dec)
 				{
+					command_kind opc = c->GetOp();
+
 					if (c->arg0) {
-						value* var = find_variable_symbol<false>(current, c,
+						value* var = find_variable_symbol<false>(current.get(), c,
 							ARG1_GET_LEVEL(c->arg1), ARG1_GET_VAR(c->arg1));
 						if (var == nullptr) break;
 						value res = (opc == command_kind::pc_inline_inc) ?
@@ -741,15 +1101,17 @@ void script_machine::run_code() {
 					}
 					break;
 				}
-				case command_kind::pc_inline_add_asi:
-				case command_kind::pc_inline_sub_asi:
-				case command_kind::pc_inline_mul_asi:
-				case command_kind::pc_inline_div_asi:
-				case command_kind::pc_inline_fdiv_asi:
-				case command_kind::pc_inline_mod_asi:
-				case command_kind::pc_inline_pow_asi:
+				VM_CASE(pc_inline_add_asi)
+				VM_CASE(pc_inline_sub_asi)
+				VM_CASE(pc_inline_mul_asi)
+				VM_CASE(pc_inline_div_asi)
+				VM_CASE(pc_inline_fdiv_asi)
+				VM_CASE(pc_inline_mod_asi)
+				VM_CASE(pc_inline_pow_asi)
 				//case command_kind::pc_inline_cat_asi:
 				{
+					command_kind opc = c->GetOp();
+
 					auto PerformFunction = [&](value* dest, command_kind cmd, value* argv) {
 #define DEF_CASE(_c, _fn) case _c: *dest = BaseFunction::_fn(this, 2, argv); break;
 						switch (cmd) {
@@ -767,7 +1129,7 @@ void script_machine::run_code() {
 
 					value res;
 					if (c->arg0) {
-						value* dest = find_variable_symbol<false>(current, c,
+						value* dest = find_variable_symbol<false>(current.get(), c,
 							ARG1_GET_LEVEL(c->arg1), ARG1_GET_VAR(c->arg1));
 						if (dest == nullptr) break;
 
@@ -794,13 +1156,15 @@ void script_machine::run_code() {
 					}
 					break;
 				}
-				case command_kind::pc_inline_cat_asi:
+				VM_CASE(pc_inline_cat_asi)
 				{
 					if (c->arg0) {
-						value* dest = find_variable_symbol<false>(current, c,
+						value* dest = find_variable_symbol<false>(current.get(), c,
 							ARG1_GET_LEVEL(c->arg1), ARG1_GET_VAR(c->arg1));
 						if (dest == nullptr) break;
 
+						//Appends in place unless the array is shared with another owner
+						dest->make_unique();
 						value arg[2] = { *dest, stack.back() };
 						BaseFunction::concatenate_direct(this, 2, arg);
 
@@ -809,6 +1173,7 @@ void script_machine::run_code() {
 					else {
 						value* pArg = &stack.back() - 1;
 
+						pArg->as_ptr()->make_unique();
 						value arg[2] = { *(pArg->as_ptr()), pArg[1] };
 						BaseFunction::concatenate_direct(this, 2, arg);
 
@@ -817,10 +1182,12 @@ void script_machine::run_code() {
 					}
 					break;
 				}
-				case command_kind::pc_inline_neg:
-				case command_kind::pc_inline_not:
-				case command_kind::pc_inline_abs:
+				VM_CASE(pc_inline_neg)
+				VM_CASE(pc_inline_not)
+				VM_CASE(pc_inline_abs)
 				{
+					command_kind opc = c->GetOp();
+
 					value res;
 					value* arg = &stack.back();
 
@@ -836,16 +1203,18 @@ void script_machine::run_code() {
 					*arg = res;
 					break;
 				}
-				case command_kind::pc_inline_add:
-				case command_kind::pc_inline_sub:
-				case command_kind::pc_inline_mul:
-				case command_kind::pc_inline_div:
-				case command_kind::pc_inline_fdiv:
-				case command_kind::pc_inline_mod:
-				case command_kind::pc_inline_pow:
-				case command_kind::pc_inline_app:
-				case command_kind::pc_inline_cat:
+				VM_CASE(pc_inline_add)
+				VM_CASE(pc_inline_sub)
+				VM_CASE(pc_inline_mul)
+				VM_CASE(pc_inline_div)
+				VM_CASE(pc_inline_fdiv)
+				VM_CASE(pc_inline_mod)
+				VM_CASE(pc_inline_pow)
+				VM_CASE(pc_inline_app)
+				VM_CASE(pc_inline_cat)
 				{
+					command_kind opc = c->GetOp();
+
 					value res;
 					value* args = &stack.back() - 1;
 
@@ -869,13 +1238,15 @@ void script_machine::run_code() {
 					stack.back() = res;
 					break;
 				}
-				case command_kind::pc_inline_cmp_e:
-				case command_kind::pc_inline_cmp_g:
-				case command_kind::pc_inline_cmp_ge:
-				case command_kind::pc_inline_cmp_l:
-				case command_kind::pc_inline_cmp_le:
-				case command_kind::pc_inline_cmp_ne:
+				VM_CASE(pc_inline_cmp_e)
+				VM_CASE(pc_inline_cmp_g)
+				VM_CASE(pc_inline_cmp_ge)
+				VM_CASE(pc_inline_cmp_l)
+				VM_CASE(pc_inline_cmp_le)
+				VM_CASE(pc_inline_cmp_ne)
 				{
+					command_kind opc = c->GetOp();
+
 					value* args = &stack.back() - 1;
 
 					value cmp_res = BaseFunction::compare(this, 2, args);
@@ -901,9 +1272,11 @@ void script_machine::run_code() {
 
 					break;
 				}
-				case command_kind::pc_inline_logic_and:
-				case command_kind::pc_inline_logic_or:
+				VM_CASE(pc_inline_logic_and)
+				VM_CASE(pc_inline_logic_or)
 				{
+					command_kind opc = c->GetOp();
+
 					value* var2 = &stack.back();
 					value* var1 = var2 - 1;
 
@@ -917,7 +1290,7 @@ void script_machine::run_code() {
 					stack.back() = res;
 					break;
 				}
-				case command_kind::pc_inline_cast_var:
+				VM_CASE(pc_inline_cast_var)
 				{
 					value* var = &stack.back();
 
@@ -937,7 +1310,7 @@ void script_machine::run_code() {
 
 					break;
 				}
-				case command_kind::pc_inline_index_array:
+				VM_CASE(pc_inline_index_array)
 				{
 					value* arr = &stack.back() - 1;
 					value* idx = arr + 1;
@@ -949,14 +1322,19 @@ void script_machine::run_code() {
 					stack.pop_back();	//pop idx
 					break;
 				}
-				case command_kind::pc_inline_index_array2:
+				VM_CASE(pc_inline_index_array2)
 				{
 					value* arr = &stack.back() - 1;
 					value* idx = arr + 1;
 
-					value* pRes = (value*)BaseFunction::index(this, 2, arr, idx);
-					if (pRes == nullptr) break;
-					value res = *pRes;
+					//Read-only, so the array is neither detached nor unpacked
+					BaseFunction::_null_check(this, arr, 1);
+					int index = idx->as_int();
+					size_t length = arr->length_as_array();
+					if (index < 0) index += length;
+					if (!BaseFunction::_index_check(this, arr->get_type(), length, index))
+						break;
+					value res = arr->array_get_value(index);
 
 					//stack.pop_back(2U);
 					//stack.push_back(res);
@@ -964,14 +1342,125 @@ void script_machine::run_code() {
 					stack.back() = res;
 					break;
 				}
-				case command_kind::pc_inline_length_array:
+				VM_CASE(pc_inline_length_array)
 				{
 					value* var = &stack.back();
 					size_t len = var->length_as_array();
 					var->reset(script_type_manager::get_int_type(), (int64_t)len);
 					break;
 				}
+
+				// ----------------------------------Superinstructions----------------------------------
+				VM_CASE(pc_fused_op_vc)
+				VM_CASE(pc_fused_op_vv)
+				VM_CASE(pc_fused_op_assign_vc)
+				VM_CASE(pc_fused_op_assign_vv)
+				VM_CASE(pc_fused_cmp_jump_vc)
+				VM_CASE(pc_fused_cmp_jump_vv)
+				{
+					command_kind opc = c->GetOp();
+
+					// Operands: [ip+0]=pc_push_variable, [ip+1]=pc_push_value/pc_push_variable,
+					//	[ip+2]=operation, [ip+3]=pc_copy_assign/pc_jump_if/pc_jump_if_not
+					value* lhs = find_variable_symbol<false>(current.get(), c, c->arg0, c->arg1);
+					if (lhs == nullptr) break;
+
+					const value* rhs = &(c[1].data);
+					if (opc == command_kind::pc_fused_op_vv || opc == command_kind::pc_fused_op_assign_vv
+						|| opc == command_kind::pc_fused_cmp_jump_vv)
+					{
+						rhs = find_variable_symbol<false>(current.get(), c + 1, c[1].arg0, c[1].arg1);
+						if (rhs == nullptr) break;
+					}
+
+					value args[2] = { *lhs, *rhs };
+					value res = _fused_binary_operate(this, c[2].GetOp(), args);
+
+					switch (opc) {
+					case command_kind::pc_fused_op_vc:
+					case command_kind::pc_fused_op_vv:
+						stack.push_back(res);
+						current->ip += 2;
+						break;
+					case command_kind::pc_fused_op_assign_vc:
+					case command_kind::pc_fused_op_assign_vv:
+					{
+						value* dest = find_variable_symbol<true>(current.get(), c + 3, c[3].arg0, c[3].arg1);
+						if (dest != nullptr && BaseFunction::_type_assign_check(this, &res, dest)) {
+							type_data* prev_type = dest->get_type();
+
+							*dest = res;
+
+							if (prev_type && prev_type != res.get_type())
+								BaseFunction::_value_cast(dest, prev_type);
+						}
+						current->ip += 3;
+						break;
+					}
+					default:
+					{
+						bool bJE = c[3].GetOp() == command_kind::pc_jump_if;
+						if (res.as_boolean() == bJE)
+							current->ip = c[3].arg0;
+						else
+							current->ip += 3;
+						break;
+					}
+					}
+					break;
 				}
+				VM_CASE(pc_fused_cmp_jump)
+				{
+					value* args = &stack.back() - 1;
+					bool b = _fused_binary_operate(this, (command_kind)c->arg0, args).as_boolean();
+
+					stack.pop_back();
+					stack.pop_back();
+
+					bool bJE = c[1].GetOp() == command_kind::pc_jump_if;
+					if (b == bJE)
+						current->ip = c[1].arg0;
+					else
+						++(current->ip);
+					break;
+				}
+				VM_CASE(pc_fused_loop_count_jump)
+				{
+					value* i = &stack.back();
+
+					int64_t r = i->as_int();
+					if (r > 0) {
+						i->reset(script_type_manager::get_int_type(), r - 1);
+						++(current->ip);
+					}
+					else
+						current->ip = c[1].arg0;
+					break;
+				}
+				VM_CASE(pc_fused_loop_range_jump)
+				{
+					value* cmp_arg = &stack.back() - 1;
+					value cmp_res = BaseFunction::compare(this, 2, cmp_arg);
+
+					bool bStopLoop = (command_kind)c->arg0 == command_kind::pc_loop_ascent ?
+						(cmp_res.as_int() <= 0) : (cmp_res.as_int() >= 0);
+					if (bStopLoop)
+						current->ip = c[1].arg0;
+					else
+						++(current->ip);
+					break;
+				}
+				VM_DEFAULT
+					break;
+				}
+				goto lab_next;
+
+#ifdef __L_SCRIPT_THREADED_DISPATCH
+lab_end:
+				--(current->ip);
+#endif
+lab_leave:
+				;
 			}
 
 #undef ARG1_GET_LEVEL
@@ -982,31 +1471,48 @@ void script_machine::run_code() {
 		std::string error = StringUtility::Format("std: %s\r\n"
 			"You shouldn't be seeing this. Please contact Natashi.\r\n", e.what());
 		raise_error(error);
+		if (c) error_line = c->GetLine();
 	}
 }
 
+#undef VM_CASE
+#undef VM_DEFAULT
+
 template<bool ALLOW_NULL>
-value* script_machine::find_variable_symbol(env_ptr current_env, code* c,
+value* script_machine::find_variable_symbol(environment* current_env, code* c,
 	uint32_t level, uint32_t variable)
 {
-	for (env_ptr i = current_env; i != nullptr; i = i->parent) {
-		if (i->sub->level == level) {
-			value* res = &(i->variables[variable]);
+	environment* env = nullptr;
+	if (current_env->sub->level == level)
+		env = current_env;
+	else if (level < current_env->display.size())
+		env = current_env->display[level];
+	if (env == nullptr) {
+		//The parent chain skipped this level, fall back to walking it
+		for (environment* i = current_env->parent.get(); i != nullptr; i = i->parent.get()) {
+			if (i->sub->level == level) {
+				env = i;
+				break;
+			}
+		}
+	}
+
+	if (env != nullptr) {
+		value* res = &(env->variables[variable]);
 
-			if constexpr (ALLOW_NULL)
+		if constexpr (ALLOW_NULL)
+			return res;
+		else {
+			if (res->has_data())
 				return res;
 			else {
-				if (res->has_data())
-					return res;
-				else {
 #ifdef _DEBUG
-					raise_error(StringUtility::Format("Variable hasn't been initialized: %s\r\n",
-						c->var_name.c_str()));
+				raise_error(StringUtility::Format("Variable hasn't been initialized: %s\r\n",
+					c->var_name.c_str()));
 #else
-					raise_error("Variable hasn't been initialized.\r\n");
+				raise_error("Variable hasn't been initialized.\r\n");
 #endif
-					return nullptr;
-				}
+				return nullptr;
 			}
 		}
 	}
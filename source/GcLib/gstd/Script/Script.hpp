@@ -32,6 +32,8 @@ namespace gstd {
 	private:
 		script_type_manager(const script_type_manager& src);
 
+		//Types are interned from the load workers as well
+		std::mutex lock;
 		std::set<type_data> types;
 
 		//Common types for quick access without std::set traversal
@@ -54,6 +56,7 @@ namespace gstd {
 
 	class script_engine {
 	public:
+		script_engine();	//Empty, to be filled in from a compiled cache
 		script_engine(const std::wstring& source, std::vector<function>* list_func, std::vector<constant>* list_const);
 		script_engine(const std::vector<char>& source, std::vector<function>* list_func, std::vector<constant>* list_const);
 		script_engine(const wchar_t* source, const wchar_t* end, std::vector<function>* list_func, std::vector<constant>* list_const);
@@ -85,7 +88,7 @@ namespace gstd {
 		class environment {
 			friend script_machine;
 		private:
-			size_t _index;
+			environment* _next_free;	//Intrusive link of the allocator's free list
 		public:
 			script_machine* machine;
 			sptr<environment> parent;
@@ -96,26 +99,39 @@ namespace gstd {
 			std::vector<value> variables;
 			std::vector<value> stack;
 
+			//Nearest ancestor environment of each lexical level below this one, so variable lookups skip the parent walk
+			//	Entries are kept alive through the parent chain
+			std::vector<environment*> display;
+
 			bool hasResult;
 			int waitCount;
 		public:
 			environment(script_machine* machine);
-			environment(const environment& base_from, sptr<environment> parent, script_block* sub);
 
-			//environment& operator=(const environment& other) = delete;
+			//Reinitializes a pooled environment in place, keeping the capacity of its vectors
+			void init(sptr<environment> parent, script_block* sub);
 		};
 
 		using env_ptr = sptr<environment>;
 
 	private:
+		//Arena of environments, allocated in chunks that never move
 		class env_allocator {
+		public:
+			static constexpr size_t CHUNK_SIZE = 1024;
+			static constexpr size_t REF_BLOCK_SIZE = 64;
 		private:
 			script_machine* machine;
 
-			std::vector<environment> environments;
-			std::list<size_t> free_environments;
+			std::vector<std::vector<environment>> chunks;
+			environment* free_environments;
+
+			//Fixed-size blocks for the reference counts of env_ptr
+			std::vector<std::unique_ptr<char[]>> chunksRefBlock;
+			void* free_ref_blocks;
 		private:
-			void _alloc_more(size_t n);
+			void _alloc_more();
+			void _alloc_more_ref_block();
 		public:
 			using value_type = environment;
 			using pointer = value_type*;
@@ -125,8 +141,47 @@ namespace gstd {
 
 			[[nodiscard]] value_type* allocate(size_t n);
 			void deallocate(value_type* p, size_t n) noexcept;
+
+			[[nodiscard]] void* allocate_ref_block(size_t size);
+			void deallocate_ref_block(void* p, size_t size) noexcept;
+		};
+
+		//Allocates the control blocks of env_ptr from env_allocator
+		template<typename T>
+		class env_ref_allocator {
+		public:
+			using value_type = T;
+
+			env_allocator* pool;
+		public:
+			env_ref_allocator(env_allocator* pool) : pool(pool) {}
+			template<typename U> env_ref_allocator(const env_ref_allocator<U>& other) : pool(other.pool) {}
+
+			[[nodiscard]] T* allocate(size_t n) { return (T*)pool->allocate_ref_block(sizeof(T) * n); }
+			void deallocate(T* p, size_t n) noexcept { pool->deallocate_ref_block(p, sizeof(T) * n); }
+
+			template<typename U> bool operator==(const env_ref_allocator<U>& other) const { return pool == other.pool; }
+			template<typename U> bool operator!=(const env_ref_allocator<U>& other) const { return pool != other.pool; }
+		};
+
+		//A microthread slot. The first thread holds the main routine and the events interrupting it.
+		//	Threads are visited back to front, one lap per wrap around the first thread.
+		struct script_thread {
+			env_ptr env;
+			uint64_t order;				//Sort key of the position in the thread list
+
+			script_thread* prev;		//All threads in order
+			script_thread* next;
+			script_thread* run_prev;	//Runnable threads in order, circular
+			script_thread* run_next;
+
+			script_thread* wait_next;	//Next in the same wait wheel bucket, or in the free list
+			uint64_t wake_lap;
 		};
 	public:
+		static constexpr size_t WAIT_WHEEL_SIZE = 256;
+		static constexpr size_t THREAD_CHUNK_SIZE = 256;
+		static constexpr uint64_t THREAD_ORDER_STEP = 1ULL << 32;
 		void* data;		// Pointer to client script class
 
 		script_engine* engine;
@@ -142,12 +197,28 @@ namespace gstd {
 
 		std::list<env_ptr> list_parent_environment;
 
-		std::list<env_ptr> threads;
-		std::list<env_ptr>::iterator current_thread_index;
+		script_thread* threads;
+		script_thread* current_thread;
+		size_t thread_count;
+
+		//Threads sleeping in wait(n), bucketed by the lap they wake up in
+		uint64_t lap;
+		script_thread* wait_wheel[WAIT_WHEEL_SIZE];
+		std::vector<script_thread*> list_woken;
+
+		std::vector<std::unique_ptr<script_thread[]>> chunksThread;
+		script_thread* free_threads;
 
 		env_allocator allocator;
 	private:
 		[[nodiscard]] env_ptr get_new_environment();
+
+		script_thread* _new_thread(env_ptr env);
+		void _delete_thread(script_thread* thread);
+		void _relabel_threads();
+		void _erase_thread(script_thread* thread);
+		void _park_thread(script_thread* thread, int waitCount);
+		void _wake_threads();
 	public:
 		script_machine(script_engine* the_engine);
 		virtual ~script_machine();
@@ -196,19 +267,20 @@ namespace gstd {
 		int get_current_line();
 		//int get_current_thread_addr() { return (int)current_thread_index._Ptr; }
 
-		size_t get_thread_count() { return threads.size(); }
+		size_t get_thread_count() { return thread_count; }
 	private:
 		void yield() {
-			if (current_thread_index == threads.begin())
-				current_thread_index = std::prev(threads.end());
-			else
-				--current_thread_index;
+			if (current_thread == threads) {
+				++lap;
+				_wake_threads();
+			}
+			current_thread = current_thread->run_prev;
 		}
 
 		void run_code();
 
 		template<bool ALLOW_NULL>
-		value* find_variable_symbol(env_ptr current_env, code* c,
+		value* find_variable_symbol(environment* current_env, code* c,
 			uint32_t level, uint32_t variable);
 	};
 }
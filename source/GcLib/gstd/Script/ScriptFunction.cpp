@@ -182,17 +182,17 @@ namespace gstd {
 			size_t ct_op = std::min(v_right->length_as_array(), ct_left);
 			value v[2];
 			for (size_t i = 0; i < ct_op; ++i) {
-				v[0] = (*v_left)[i];
-				v[1] = (*v_right)[i];
+				v[0] = v_left->array_get_value(i);
+				v[1] = v_right->array_get_value(i);
 				resArr[i] = func(2, v);
 			}
-			for (size_t i = ct_op; i < ct_left; ++i) resArr[i] = (*v_left)[i];
+			for (size_t i = ct_op; i < ct_left; ++i) resArr[i] = v_left->array_get_value(i);
 		}
 		else {
 			value v[2];
 			v[1] = *v_right;
 			for (size_t i = 0; i < ct_left; ++i) {
-				v[0] = (*v_left)[i];
+				v[0] = v_left->array_get_value(i);
 				resArr[i] = func(2, v);
 			}
 		}
@@ -248,7 +248,7 @@ namespace gstd {
 		case type_data::tk_array:
 			if (type_data* castElem = cast->get_element()) {
 				if (val->length_as_array() > 0) {
-					std::vector<value> arrVal = *(val->as_array_ptr());
+					std::vector<value> arrVal = val->as_array();
 					for (value& iVal : arrVal)
 						_value_cast(&iVal, castElem);
 					return val->reset(cast, arrVal);
@@ -424,7 +424,7 @@ namespace gstd {
 		type_data* elemType = nullptr;
 
 		for (size_t i = 0; i < arrVal.size(); ++i) {
-			value nv = (*val)[i];
+			value nv = val->array_get_value(i);
 
 			if (nv.get_type()->get_kind() == type_data::tk_array) {
 				type_data* nextElemType = __cast_array(machine, rootType, &nv, setType);
@@ -606,7 +606,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = _script_negative(1, &(*argv)[i]);
+				value v = argv->array_get_value(i);
+				resArr[i] = _script_negative(1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -683,8 +684,8 @@ namespace gstd {
 					else {
 						value v[2];
 						for (size_t i = 0; i < sr; ++i) {
-							v[0] = argv[0][i];
-							v[1] = argv[1][i];
+							v[0] = argv[0].array_get_value(i);
+							v[1] = argv[1].array_get_value(i);
 							r = _script_compare(2, v).as_float();
 							if (r != 0)
 								break;
@@ -740,7 +741,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = predecessor(machine, 1, &(*argv)[i]);
+				value v = argv->array_get_value(i);
+				resArr[i] = predecessor(machine, 1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -770,7 +772,8 @@ namespace gstd {
 			std::vector<value> resArr;
 			resArr.resize(argv->length_as_array());
 			for (size_t i = 0; i < argv->length_as_array(); ++i) {
-				resArr[i] = successor(machine, 1, &(*argv)[i]);
+				value v = argv->array_get_value(i);
+				resArr[i] = successor(machine, 1, &v);
 			}
 			result.reset(argv->get_type(), resArr);
 			return result;
@@ -808,7 +811,7 @@ namespace gstd {
 			std::vector<value> arrVal(newSize);
 
 			for (size_t i = 0; i < oldSize && i < newSize; ++i)
-				arrVal[i] = (*val)[i];
+				arrVal[i] = val->array_get_value(i);
 			if (newSize > oldSize) {
 				value fill;
 				if (argc == 3) {	//Has fill value
@@ -856,7 +859,7 @@ namespace gstd {
 
 		bool res = false;
 		for (size_t i = 0; i < length; ++i) {
-			value args[2] = { (*arr)[i], val };
+			value args[2] = { arr->array_get_value(i), val };
 			if (compare(machine, 2, args).as_int() == 0) {
 				res = true;
 				break;
@@ -888,7 +891,7 @@ namespace gstd {
 		if (addType != elemType)
 			BaseFunction::_value_cast(&replaceTo, elemType);
 
-		std::vector<value> arrVal = *val->as_array_ptr();
+		std::vector<value> arrVal = val->as_array();
 
 		for (size_t i = 0; i < size; ++i) {
 			value args[2] = { arrVal[i], replaceFrom };
@@ -921,7 +924,7 @@ namespace gstd {
 
 		// Populate source array
 		for (size_t i = 0; i < size; ++i)
-			arrVal[i] = (*val)[i];
+			arrVal[i] = val->array_get_value(i);
 
 		for (size_t i = 0; i < size; ++i) {
 			for (size_t j = 1; j <= count; ++j) {
@@ -951,7 +954,9 @@ namespace gstd {
 		if (!_index_check(machine, arr->get_type(), length, index))
 			return nullptr;
 
-		return &(*arr)[index];
+		//The element may be written through the returned pointer, detach from any other owner first
+		arr->make_unique();
+		return &arr->index_as_array(index);
 	}
 
 	value BaseFunction::slice(script_machine* machine, int argc, const value* argv) {
@@ -983,11 +988,7 @@ namespace gstd {
 				index_1 = std::max<int>(index_1, 0);
 				index_2 = std::min<int>(index_2, length);
 
-				resArr.resize(index_2 - index_1);
-				for (size_t i = 0, j = index_1; i < resArr.size(); ++i, ++j) {
-					const value& v = argv[0][j];
-					resArr[i] = v;
-				}
+				return argv[0].slice_as_array(index_1, index_2);
 			}
 			else if (index_1 > index_2) {		//Reverse
 				index_1 = std::min<int>(index_1, length);
@@ -995,8 +996,7 @@ namespace gstd {
 
 				resArr.resize(index_1 - index_2);
 				for (size_t i = 0, j = index_1 - 1; i < resArr.size(); ++i, --j) {
-					const value& v = argv[0][j];
-					resArr[i] = v;
+					resArr[i] = argv[0].array_get_value(j);
 				}
 			}
 		}
@@ -1054,11 +1054,11 @@ namespace gstd {
 		{
 			size_t iArr = 0;
 			for (size_t i = 0; i < insertPos; ++i) {
-				resArr[iArr++] = argv[0][i];
+				resArr[iArr++] = argv[0].array_get_value(i);
 			}
 			resArr[iArr++] = insertVal;
 			for (size_t i = insertPos; i < length; ++i) {
-				resArr[iArr++] = argv[0][i];
+				resArr[iArr++] = argv[0].array_get_value(i);
 			}
 		}
 
@@ -1088,15 +1088,21 @@ namespace gstd {
 			return value();
 		}
 
+		//Erasing from either end is just a slice
+		if (index_1 == 0)
+			return argv[0].slice_as_array(1, length);
+		else if (index_1 == length - 1)
+			return argv[0].slice_as_array(0, length - 1);
+
 		std::vector<value> resArr;
 		resArr.resize(length - 1U);
 		{
 			size_t iArr = 0;
 			for (size_t i = 0; i < index_1; ++i) {
-				resArr[iArr++] = argv[0][i];
+				resArr[iArr++] = argv[0].array_get_value(i);
 			}
 			for (size_t i = index_1 + 1; i < length; ++i) {
-				resArr[iArr++] = argv[0][i];
+				resArr[iArr++] = argv[0].array_get_value(i);
 			}
 		}
 
@@ -60,10 +60,8 @@ value::value(type_data* t, value* v) {
 	this->set(t, v);
 }
 value::value(type_data* t, const std::wstring& v) {
-	std::vector<value> vec(v.size());
-	for (size_t i = 0; i < v.size(); ++i)
-		vec[i] = value(t->get_element(), v[i]);
-	this->set(t, vec);
+	ref_unsync_ptr<value_array> nv(new value_array(t->get_element(), v));
+	this->set(t, nv);
 }
 value::~value() {
 	this->release();
@@ -135,11 +133,11 @@ value* value::set(type_data* t, value* v) {
 value* value::set(type_data* t, const std::vector<value>& v) {
 	kind = type_data::tk_array;
 	type = t;
-	ref_unsync_ptr<std::vector<value>> nv(new std::vector<value>(v));
+	ref_unsync_ptr<value_array> nv(new value_array(t ? t->get_element() : nullptr, v));
 	new (&p_array_value) auto(nv);
 	return this;
 }
-value* value::set(type_data* t, ref_unsync_ptr<std::vector<value>> v) {
+value* value::set(type_data* t, ref_unsync_ptr<value_array> v) {
 	kind = type_data::tk_array;
 	type = t;
 	new (&p_array_value) auto(v);
@@ -179,10 +177,9 @@ value& value::operator=(const value& source) {
 void value::make_unique() {
 	if (has_data() && kind == type_data::tk_array) {
 		if (p_array_value.use_count() == 1) return;
-		std::vector<value> vec = *p_array_value.get();
-		for (value& v : vec)
-			v.make_unique();
-		this->reset(type, vec);
+		//Shallow copy, nested arrays stay shared until they are written to themselves
+		ref_unsync_ptr<value_array> nv(new value_array(*p_array_value));
+		p_array_value = nv;
 	}
 }
 
@@ -199,8 +196,8 @@ void value::concatenate(const value& x) {
 	//make_unique();
 	if (type->get_element() == nullptr)
 		type = x.type;
-	p_array_value->insert(array_get_end(),
-		x.array_get_begin(), x.array_get_end());
+	if (x.has_data() && x.kind == type_data::tk_array)
+		p_array_value->append(*x.p_array_value);
 }
 
 size_t value::length_as_array() const {
@@ -210,22 +207,42 @@ size_t value::length_as_array() const {
 }
 const value& value::index_as_array(size_t i) const {
 	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->at(i);
+		return p_array_value->unpack().at(i);
 	throw wexception("index_as_array: not an array");
 }
 value& value::index_as_array(size_t i) {
 	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->at(i);
+		return p_array_value->unpack().at(i);
 	throw wexception("index_as_array: not an array");
 }
+value value::array_get_value(size_t i) const {
+	if (has_data() && kind == type_data::tk_array) {
+		if (i < p_array_value->size())
+			return p_array_value->get(i);
+		throw std::out_of_range("array_get_value: index out of range");
+	}
+	throw wexception("array_get_value: not an array");
+}
+value value::slice_as_array(size_t first, size_t last) const {
+	if (has_data() && kind == type_data::tk_array) {
+		if (first <= last && last <= p_array_value->size()) {
+			value res;
+			ref_unsync_ptr<value_array> nv(new value_array(p_array_value, first, last - first));
+			res.set(type, nv);
+			return res;
+		}
+		throw std::out_of_range("slice_as_array: index out of range");
+	}
+	throw wexception("slice_as_array: not an array");
+}
 std::vector<value>::iterator value::array_get_begin() const {
 	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->begin();
+		return p_array_value->unpack().begin();
 	return std::vector<value>::iterator();
 }
 std::vector<value>::iterator value::array_get_end() const {
 	if (has_data() && kind == type_data::tk_array)
-		return p_array_value->end();
+		return p_array_value->unpack().end();
 	return std::vector<value>::iterator();
 }
 
@@ -328,17 +345,19 @@ std::wstring value::as_string() const {
 	if (kind == type_data::tk_array) {
 		std::wstring result = L"";
 		if (type_data* elem = type->get_element()) {
+			size_t length = p_array_value->size();
 			if (elem->get_kind() == type_data::tk_char) {
-				for (auto itr = p_array_value->begin(); itr != p_array_value->end(); ++itr)
-					result += itr->as_char();
+				if (p_array_value->get_packed_string(&result))
+					return result;
+				result.reserve(length);
+				for (size_t i = 0; i < length; ++i)
+					result += p_array_value->get(i).as_char();
 			}
 			else {
 				result = L"[";
-				auto itr = p_array_value->begin();
-				while (itr != p_array_value->end()) {
-					result += itr->as_string();
-					if ((++itr) == p_array_value->end()) break;
-					result += L",";
+				for (size_t i = 0; i < length; ++i) {
+					if (i > 0) result += L",";
+					result += p_array_value->get(i).as_string();
 				}
 				result += L"]";
 			}
@@ -348,9 +367,247 @@ std::wstring value::as_string() const {
 	}
 	return L"(INVALID-TYPE)";
 }
-ref_unsync_ptr<std::vector<value>> value::as_array_ptr() const {
-	if (!has_data()) return nullptr;
-	if (kind == type_data::tk_array)
-		return p_array_value;
-	return nullptr;
+bool value::as_string_view(std::wstring_view* out) const {
+	if (!has_data() || kind != type_data::tk_array) return false;
+
+	type_data* elem = type->get_element();
+	if (elem == nullptr || elem->get_kind() != type_data::tk_char) return false;
+
+	return p_array_value->get_packed_string(out);
+}
+std::vector<value> value::as_array() const {
+	if (has_data() && kind == type_data::tk_array)
+		return p_array_value->to_vector();
+	return std::vector<value>();
+}
+
+//****************************************************************************
+//value_array
+//****************************************************************************
+bool value_array::_is_packable(type_data* elem) {
+	if (elem == nullptr) return false;
+	switch (elem->get_kind()) {
+	case type_data::tk_char:
+	case type_data::tk_int:
+	case type_data::tk_float:
+		return true;
+	}
+	return false;
+}
+
+value_array::value_array(type_data* elem, const std::vector<value>& vec) {
+	//Only pack if every element is exactly of the element type, so unpacking gives back the same values
+	bool bPack = _is_packable(elem);
+	for (size_t i = 0; bPack && i < vec.size(); ++i)
+		bPack = vec[i].get_type() == elem;
+
+	if (!bPack) {
+		data = vec;
+		return;
+	}
+
+	element = elem;
+	switch (elem->get_kind()) {
+	case type_data::tk_char:
+	{
+		string_t& dst = data.emplace<string_t>(vec.size(), L'\0');
+		for (size_t i = 0; i < vec.size(); ++i)
+			dst[i] = vec[i].as_char();
+		break;
+	}
+	case type_data::tk_int:
+	{
+		int_array_t& dst = data.emplace<int_array_t>(vec.size());
+		for (size_t i = 0; i < vec.size(); ++i)
+			dst[i] = vec[i].as_int();
+		break;
+	}
+	case type_data::tk_float:
+	{
+		float_array_t& dst = data.emplace<float_array_t>(vec.size());
+		for (size_t i = 0; i < vec.size(); ++i)
+			dst[i] = vec[i].as_float();
+		break;
+	}
+	}
+}
+value_array::value_array(type_data* elem, const std::wstring& str) {
+	if (elem != nullptr && elem->get_kind() == type_data::tk_char) {
+		element = elem;
+		data.emplace<string_t>(str);
+	}
+	else {
+		generic_t& dst = data.emplace<generic_t>(str.size());
+		for (size_t i = 0; i < str.size(); ++i)
+			dst[i] = value(elem, str[i]);
+	}
+}
+
+value_array::value_array(ref_unsync_ptr<value_array> source, size_t offset, size_t count) {
+	if (const view_t* view = std::get_if<view_t>(&source->data)) {
+		ref_unsync_ptr<value_array> base = view->source;
+		offset += view->offset;
+		source = base;
+	}
+	element = source->element;
+	data.emplace<view_t>(view_t{ source, offset, count });
+
+	//Short slices are cheaper to copy outright, and a small view shouldn't keep a much larger buffer alive
+	if (count < 32 || count * 2 < source->size())
+		_materialize();
+}
+
+void value_array::_materialize() {
+	view_t* view = std::get_if<view_t>(&data);
+	if (view == nullptr) return;
+
+	ref_unsync_ptr<value_array> source = view->source;
+	size_t offset = view->offset;
+	size_t count = view->count;
+	std::visit([&](const auto& src) {
+		using T = std::decay_t<decltype(src)>;
+		if constexpr (!std::is_same_v<T, view_t>)
+			data = T(src.begin() + offset, src.begin() + offset + count);
+	}, source->data);
+}
+
+bool value_array::get_packed_string(std::wstring* out) const {
+	const value_array* src = this;
+	size_t offset = 0;
+	size_t count = size();
+	if (const view_t* view = std::get_if<view_t>(&data)) {
+		src = view->source.get();
+		offset = view->offset;
+	}
+	if (const string_t* str = std::get_if<string_t>(&src->data)) {
+		out->assign(*str, offset, count);
+		return true;
+	}
+	return false;
+}
+bool value_array::get_packed_string(std::wstring_view* out) const {
+	const value_array* src = this;
+	size_t offset = 0;
+	size_t count = size();
+	if (const view_t* view = std::get_if<view_t>(&data)) {
+		src = view->source.get();
+		offset = view->offset;
+	}
+	if (const string_t* str = std::get_if<string_t>(&src->data)) {
+		*out = std::wstring_view(*str).substr(offset, count);
+		return true;
+	}
+	return false;
+}
+
+size_t value_array::size() const {
+	return std::visit([](const auto& arr) { return arr.size(); }, data);
+}
+value value_array::get(size_t i) const {
+	switch (data.index()) {
+	case 1:
+		return value(element, std::get<string_t>(data)[i]);
+	case 2:
+		return value(element, std::get<int_array_t>(data)[i]);
+	case 3:
+		return value(element, std::get<float_array_t>(data)[i]);
+	case 4:
+	{
+		const view_t& view = std::get<view_t>(data);
+		return view.source->get(view.offset + i);
+	}
+	}
+	return std::get<generic_t>(data)[i];
+}
+
+value_array::generic_t& value_array::unpack() {
+	_materialize();
+	if (is_packed()) {
+		generic_t vec = to_vector();
+		data = MOVE(vec);
+		element = nullptr;
+	}
+	return std::get<generic_t>(data);
+}
+value_array::generic_t value_array::to_vector() const {
+	if (const generic_t* vec = std::get_if<generic_t>(&data))
+		return *vec;
+
+	size_t count = size();
+	generic_t res(count);
+	for (size_t i = 0; i < count; ++i)
+		res[i] = get(i);
+	return res;
+}
+
+void value_array::push_back(const value& v) {
+	_materialize();
+
+	//An empty generic store can still become packed
+	if (!is_packed() && std::get<generic_t>(data).empty() && _is_packable(v.get_type())) {
+		std::vector<value> vec = { v };
+		*this = value_array(v.get_type(), vec);
+		return;
+	}
+
+	if (is_packed_as(v.get_type())) {
+		switch (data.index()) {
+		case 1:
+			std::get<string_t>(data).push_back(v.as_char());
+			return;
+		case 2:
+			std::get<int_array_t>(data).push_back(v.as_int());
+			return;
+		case 3:
+			std::get<float_array_t>(data).push_back(v.as_float());
+			return;
+		}
+	}
+	unpack().push_back(v);
+}
+void value_array::append(const value_array& other) {
+	size_t count = other.size();
+	if (count == 0) return;
+
+	_materialize();
+	if (size() == 0 && !is_packed() && other.data.index() != 0) {
+		*this = other;
+		return;
+	}
+
+	//Appending a view copies straight from the range of its source
+	const value_array* src = &other;
+	size_t offset = 0;
+	if (const view_t* view = std::get_if<view_t>(&other.data)) {
+		src = view->source.get();
+		offset = view->offset;
+	}
+	if (src->is_packed() && is_packed_as(src->element)) {
+		std::visit([&](auto& dst) {
+			using T = std::decay_t<decltype(dst)>;
+			if constexpr (!std::is_same_v<T, generic_t> && !std::is_same_v<T, view_t>) {
+				if (src == this) {
+					T tmp(dst.begin() + offset, dst.begin() + offset + count);
+					dst.insert(dst.end(), tmp.begin(), tmp.end());
+				}
+				else {
+					const T& arr = std::get<T>(src->data);
+					dst.insert(dst.end(), arr.begin() + offset, arr.begin() + offset + count);
+				}
+			}
+		}, data);
+		return;
+	}
+
+	generic_t& dst = unpack();
+	if (&other == this) {
+		dst.reserve(dst.size() * 2);
+		for (size_t i = 0; i < count; ++i)
+			dst.push_back(dst[i]);
+	}
+	else {
+		dst.reserve(dst.size() + count);
+		for (size_t i = 0; i < count; ++i)
+			dst.push_back(other.get(i));
+	}
 }
\ No newline at end of file
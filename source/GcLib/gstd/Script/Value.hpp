@@ -33,6 +33,8 @@ namespace gstd {
 		type_data* element = nullptr;
 	};
 
+	class value_array;
+
 	class value {
 	private:
 		type_data::type_kind kind = type_data::tk_null;
@@ -45,7 +47,7 @@ namespace gstd {
 			bool boolean_value;
 			int64_t int_value;
 			value* ptr_value;
-			ref_unsync_ptr<std::vector<value>> p_array_value;
+			ref_unsync_ptr<value_array> p_array_value;
 		};
 	public:
 		value() {}
@@ -78,7 +80,7 @@ namespace gstd {
 		value* set(type_data* t, bool v);
 		value* set(type_data* t, value* v);
 		value* set(type_data* t, const std::vector<value>& v);
-		value* set(type_data* t, ref_unsync_ptr<std::vector<value>> v);
+		value* set(type_data* t, ref_unsync_ptr<value_array> v);
 		value* set(type_data* t);
 
 		void make_unique();
@@ -94,11 +96,13 @@ namespace gstd {
 		size_t length_as_array() const;
 		const value& index_as_array(size_t i) const;
 		value& index_as_array(size_t i);
+		value array_get_value(size_t i) const;
+		value slice_as_array(size_t first, size_t last) const;
 
 		std::vector<value>::iterator array_get_begin() const;
 		std::vector<value>::iterator array_get_end() const;
 
-		const value& operator[](size_t i) const { return index_as_array(i); }
+		value operator[](size_t i) const { return array_get_value(i); }
 
 		//--------------------------------------------------------------------------
 
@@ -108,8 +112,57 @@ namespace gstd {
 		bool as_boolean() const;
 		value* as_ptr() const { return ptr_value; }
 		std::wstring as_string() const;
+		//Views a packed char array without copying it, valid until the array is modified or released
+		bool as_string_view(std::wstring_view* out) const;
 
-		ref_unsync_ptr<std::vector<value>> as_array_ptr() const;
+		std::vector<value> as_array() const;
 	};
 #pragma pack(pop)
+
+	//Shared, copy-on-write backing store of array values.
+	//	Char, int and float arrays are kept packed, and only switch to a vector of values
+	//	when something needs to reference the elements themselves.
+	//	A slice can also be a read-only view into another store, copied out on the first write.
+	class value_array {
+	public:
+		using generic_t = std::vector<value>;
+		using string_t = std::wstring;
+		using int_array_t = std::vector<int64_t>;
+		using float_array_t = std::vector<double>;
+
+		struct view_t {
+			ref_unsync_ptr<value_array> source;
+			size_t offset;
+			size_t count;
+
+			size_t size() const { return count; }
+		};
+	private:
+		type_data* element = nullptr;	//Element type of the packed store
+		std::variant<generic_t, string_t, int_array_t, float_array_t, view_t> data;
+	private:
+		static bool _is_packable(type_data* elem);
+
+		void _materialize();
+	public:
+		value_array() = default;
+		value_array(type_data* elem, const std::vector<value>& vec);
+		value_array(type_data* elem, const std::wstring& str);
+		value_array(ref_unsync_ptr<value_array> source, size_t offset, size_t count);
+
+		bool is_packed() const { return data.index() != 0 && !is_view(); }
+		bool is_packed_as(type_data* elem) const { return is_packed() && element == elem; }
+		bool is_view() const { return std::holds_alternative<view_t>(data); }
+		bool get_packed_string(std::wstring* out) const;
+		bool get_packed_string(std::wstring_view* out) const;
+
+		size_t size() const;
+		value get(size_t i) const;
+
+		generic_t& unpack();
+		generic_t to_vector() const;
+
+		void push_back(const value& v);
+		void append(const value_array& other);
+	};
 }
\ No newline at end of file
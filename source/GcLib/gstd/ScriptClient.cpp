@@ -25,26 +25,492 @@ void ScriptEngineData::SetSource(std::vector<char>& source) {
 ScriptEngineCache::ScriptEngineCache() {
 }
 void ScriptEngineCache::Clear() {
+	Lock lock(lock_);
 	cache_.clear();
 }
 ScriptEngineData* ScriptEngineCache::AddCache(const std::wstring& name, uptr<ScriptEngineData>&& data) {
+	Lock lock(lock_);
 	auto& res = (cache_[name] = MOVE(data));
 	return res.get();
 }
 void ScriptEngineCache::RemoveCache(const std::wstring& name) {
+	Lock lock(lock_);
 	auto itrFind = cache_.find(name);
 	if (cache_.find(name) != cache_.end())
 		cache_.erase(itrFind);
 }
 ScriptEngineData* ScriptEngineCache::GetCache(const std::wstring& name) {
+	Lock lock(lock_);
 	auto itrFind = cache_.find(name);
 	if (cache_.find(name) == cache_.end()) return nullptr;
 	return itrFind->second.get();
 }
 bool ScriptEngineCache::IsExists(const std::wstring& name) {
+	Lock lock(lock_);
 	return cache_.find(name) != cache_.end();
 }
 
+//****************************************************************************
+//ScriptBytecodeCache
+//****************************************************************************
+gstd::CriticalSection ScriptBytecodeCache::lock_;
+
+namespace {
+	//Function reference values are ints tagged with this in their top 16 bits, see parser::parse_clause
+	constexpr uint64_t FUNC_REF_TAG = 0x6a53;
+	constexpr uint8_t TYPE_NONE = 0xff;
+
+	struct _bytecode_error {};
+
+	class _HashFNV {
+		uint64_t hash_ = 0xcbf29ce484222325ULL;
+	public:
+		void Add(const void* data, size_t size) {
+			const uint8_t* ptr = (const uint8_t*)data;
+			for (size_t i = 0; i < size; ++i)
+				hash_ = (hash_ ^ ptr[i]) * 0x100000001b3ULL;
+		}
+		template<typename T> void AddValue(T data) { Add(&data, sizeof(T)); }
+		template<typename E> void AddString(const std::basic_string<E>& str) {
+			AddValue<uint32_t>(str.size());
+			Add(str.data(), str.size() * sizeof(E));
+		}
+
+		uint64_t Get() const { return hash_; }
+	};
+
+	class _BytecodeWriter {
+		ByteBuffer& buf_;
+		std::unordered_map<const script_block*, uint32_t> mapBlockIndex_;
+		std::unordered_map<uint32_t, uint32_t> mapBlockAddress_;
+	public:
+		_BytecodeWriter(ByteBuffer& buf, script_engine* engine) : buf_(buf) {
+			uint32_t index = 0;
+			for (const script_block& block : engine->blocks) {
+				mapBlockIndex_[&block] = index;
+				mapBlockAddress_[(uint32_t)(uintptr_t)&block] = index;
+				++index;
+			}
+		}
+
+		template<typename T> void Write(T data) { buf_.Write(&data, sizeof(T)); }
+		void WriteString(const std::string& str) {
+			Write<uint32_t>(str.size());
+			buf_.Write((LPVOID)str.data(), str.size());
+		}
+
+		uint32_t GetBlockIndex(const script_block* block) {
+			auto itr = mapBlockIndex_.find(block);
+			if (itr == mapBlockIndex_.end()) throw _bytecode_error();
+			return itr->second;
+		}
+
+		void WriteType(type_data* type) {
+			if (type == nullptr) {
+				Write<uint8_t>(TYPE_NONE);
+				return;
+			}
+			Write<uint8_t>(type->get_kind());
+			if (type->get_kind() == type_data::tk_array)
+				WriteType(type->get_element());
+		}
+		void WriteValue(const value& val) {
+			type_data* type = val.get_type();
+			WriteType(type);
+			if (type == nullptr) return;
+
+			switch (type->get_kind()) {
+			case type_data::tk_int:
+			{
+				uint64_t data = (uint64_t)val.as_int();
+				auto itrBlock = mapBlockAddress_.find((uint32_t)data);
+				if ((data >> 48) == FUNC_REF_TAG && itrBlock != mapBlockAddress_.end()) {
+					Write<uint8_t>(1);
+					Write<uint32_t>(itrBlock->second);
+					Write<uint32_t>(data >> 32);
+				}
+				else {
+					Write<uint8_t>(0);
+					Write<uint64_t>(data);
+				}
+				break;
+			}
+			case type_data::tk_float:
+				Write<double>(val.as_float());
+				break;
+			case type_data::tk_char:
+				Write<uint32_t>(val.as_char());
+				break;
+			case type_data::tk_boolean:
+				Write<uint8_t>(val.as_boolean());
+				break;
+			case type_data::tk_array:
+			{
+				size_t length = val.length_as_array();
+				Write<uint32_t>(length);
+				for (size_t i = 0; i < length; ++i)
+					WriteValue(val.array_get_value(i));
+				break;
+			}
+			default:
+				throw _bytecode_error();
+			}
+		}
+	};
+
+	class _BytecodeReader {
+		ByteBuffer& buf_;
+		std::vector<script_block*> listBlock_;
+	public:
+		_BytecodeReader(ByteBuffer& buf) : buf_(buf) {}
+
+		void Read(void* dst, size_t size) {
+			if (buf_.Read(dst, size) != size) throw _bytecode_error();
+		}
+		template<typename T> T Read() {
+			T res{};
+			Read(&res, sizeof(T));
+			return res;
+		}
+		std::string ReadString() {
+			uint32_t size = Read<uint32_t>();
+			if (buf_.GetOffset() + size > buf_.GetSize()) throw _bytecode_error();
+			std::string res(size, '\0');
+			Read(res.data(), size);
+			return res;
+		}
+
+		void AddBlock(script_block* block) { listBlock_.push_back(block); }
+		script_block* GetBlock(uint32_t index) {
+			if (index >= listBlock_.size()) throw _bytecode_error();
+			return listBlock_[index];
+		}
+
+		type_data* ReadType() {
+			uint8_t kind = Read<uint8_t>();
+			if (kind == TYPE_NONE) return nullptr;
+
+			script_type_manager* typeManager = script_type_manager::get_instance();
+			if (kind == type_data::tk_array)
+				return typeManager->get_array_type(ReadType());
+			return typeManager->get_type((type_data::type_kind)kind);
+		}
+		value ReadValue() {
+			type_data* type = ReadType();
+			if (type == nullptr) return value();
+
+			switch (type->get_kind()) {
+			case type_data::tk_int:
+			{
+				if (Read<uint8_t>()) {
+					script_block* block = GetBlock(Read<uint32_t>());
+					uint64_t data = ((uint64_t)Read<uint32_t>() << 32) | ((uint64_t)(uintptr_t)block & 0xffffffff);
+					return value(type, (int64_t)data);
+				}
+				return value(type, (int64_t)Read<uint64_t>());
+			}
+			case type_data::tk_float:
+				return value(type, Read<double>());
+			case type_data::tk_char:
+				return value(type, (wchar_t)Read<uint32_t>());
+			case type_data::tk_boolean:
+				return value(type, (bool)Read<uint8_t>());
+			case type_data::tk_array:
+			{
+				uint32_t length = Read<uint32_t>();
+				if (length > buf_.GetSize() - buf_.GetOffset()) throw _bytecode_error();
+
+				std::vector<value> arr(length);
+				for (value& v : arr)
+					v = ReadValue();
+
+				value res;
+				res.reset(type, arr);
+				return res;
+			}
+			}
+			throw _bytecode_error();
+		}
+	};
+
+	std::vector<const function*> _GetFunctionTable(const std::vector<function>& listFunc) {
+		std::vector<const function*> res;
+		for (const function& func : parser::get_base_operations())
+			res.push_back(&func);
+		for (const function& func : listFunc)
+			res.push_back(&func);
+		return res;
+	}
+}
+
+uint64_t ScriptBytecodeCache::ComputeKey(const std::wstring& path, const std::vector<char>& source, ScriptFileLineMap* mapLine,
+	const std::vector<function>& listFunc, const std::vector<constant>& listConst)
+{
+	_HashFNV hash;
+
+	hash.AddValue<uint32_t>(VERSION);
+	hash.AddValue<uint32_t>(BYTECODE_VERSION);
+	hash.AddValue<uint32_t>((uint32_t)command_kind::_pc_count);
+	hash.AddValue<uint32_t>(sizeof(code));
+
+	hash.AddString(path);
+	hash.AddValue<uint32_t>(source.size());
+	hash.Add(source.data(), source.size());
+
+	for (const ScriptFileLineMap::Entry& entry : mapLine->GetEntryList()) {
+		hash.AddValue<int>(entry.lineStart_);
+		hash.AddValue<int>(entry.lineEnd_);
+		hash.AddValue<int>(entry.lineStartOriginal_);
+		hash.AddValue<int>(entry.lineEndOriginal_);
+		hash.AddString(entry.path_);
+	}
+
+	for (const function* func : _GetFunctionTable(listFunc)) {
+		hash.AddString(std::string(func->name));
+		hash.AddValue<int>(func->argc);
+	}
+	for (const constant& iConst : listConst) {
+		hash.AddString(std::string(iConst.name));
+		hash.AddValue<uint8_t>(iConst.type);
+		switch (iConst.type) {
+		case type_data::tk_char:
+			hash.AddValue<wchar_t>((const wchar_t&)iConst.data);
+			break;
+		case type_data::tk_boolean:
+			hash.AddValue<bool>((const bool&)iConst.data);
+			break;
+		default:
+			hash.AddValue<uint64_t>(iConst.data);
+			break;
+		}
+	}
+
+	return hash.Get();
+}
+
+std::wstring ScriptBytecodeCache::GetCachePath(const std::wstring& dir, const std::wstring& pathScript, uint64_t key) {
+	_HashFNV hashPath;
+	hashPath.AddString(pathScript);
+	return dir + StringUtility::Format(L"%016llx_%016llx.dat", hashPath.Get(), key);
+}
+void ScriptBytecodeCache::Prune(const std::wstring& dir, const std::wstring& pathScript, uint64_t key) {
+	std::wstring nameKeep = PathProperty::GetFileName(GetCachePath(dir, pathScript, key));
+	std::wstring prefix = nameKeep.substr(0, 17);	//"<path hash>_"
+
+	auto _IsCacheFileName = [](const std::wstring& name) {
+		if (name.size() != 16 + 1 + 16 + 4 || name[16] != L'_' || name.substr(33) != L".dat")
+			return false;
+		for (size_t i = 0; i < 33; ++i) {
+			if (i != 16 && !iswxdigit(name[i])) return false;
+		}
+		return true;
+	};
+
+	Lock lock(lock_);
+
+	std::error_code err;
+	for (const std::wstring& path : File::GetFilePathList(dir)) {
+		std::wstring name = PathProperty::GetFileName(path);
+		if (name == nameKeep) continue;
+		if (!_IsCacheFileName(name) || name.compare(0, prefix.size(), prefix) == 0)
+			stdfs::remove(path, err);
+	}
+}
+
+bool ScriptBytecodeCache::Save(const std::wstring& path, uint64_t key, script_engine* engine,
+	const std::vector<function>& listFunc)
+{
+	ByteBuffer buf;
+	try {
+		_BytecodeWriter writer(buf, engine);
+		std::vector<const function*> listFuncTable = _GetFunctionTable(listFunc);
+
+		writer.Write<uint32_t>(engine->blocks.size());
+		for (const script_block& block : engine->blocks) {
+			writer.Write<uint32_t>(block.level);
+			writer.Write<uint32_t>(block.arguments);
+			writer.WriteString(block.name);
+			writer.Write<uint8_t>((uint8_t)block.kind);
+
+			int32_t indexFunc = -1;
+			if (block.func) {
+				for (size_t i = 0; i < listFuncTable.size(); ++i) {
+					const function* func = listFuncTable[i];
+					if (func->func == block.func && func->argc == block.arguments && block.name == func->name) {
+						indexFunc = i;
+						break;
+					}
+				}
+				if (indexFunc < 0) return false;
+			}
+			writer.Write<int32_t>(indexFunc);
+		}
+
+		for (const script_block& block : engine->blocks) {
+			writer.Write<uint32_t>(block.codes.size());
+			for (const code& c : block.codes) {
+				command_kind op = c.GetOp();
+				writer.Write<uint8_t>((uint8_t)op);
+				writer.Write<uint32_t>(c.GetLine());
+#ifdef _DEBUG
+				writer.WriteString(c.var_name);
+#endif
+
+				switch (op) {
+				case command_kind::pc_push_value:
+					writer.WriteValue(c.data);
+					break;
+				case command_kind::pc_call:
+				case command_kind::pc_call_and_push_result:
+					writer.Write<uint32_t>(writer.GetBlockIndex(c.block));
+					writer.Write<uint32_t>(c.arg1);
+					break;
+				case command_kind::pc_inline_cast_var:
+					writer.WriteType((type_data*)c.arg0);
+					writer.Write<uint32_t>(c.arg1);
+					break;
+				default:
+					writer.Write<uint64_t>(c.arg0);
+					writer.Write<uint32_t>(c.arg1);
+					break;
+				}
+			}
+		}
+
+		writer.Write<uint32_t>(writer.GetBlockIndex(engine->main_block));
+		writer.Write<uint32_t>(engine->events.size());
+		for (auto& [name, block] : engine->events) {
+			writer.WriteString(name);
+			writer.Write<uint32_t>(writer.GetBlockIndex(block));
+		}
+	}
+	catch (const _bytecode_error&) {
+		//Holds something that can't be stored, like a pointer value
+		return false;
+	}
+
+	Lock lock(lock_);
+
+	File::CreateFileDirectory(path);
+
+	File file(path);
+	if (!file.Open(File::WRITEONLY))
+		return false;
+
+	file.Write((LPVOID)HEADER, sizeof(HEADER) - 1);
+	file.WriteValue<uint32_t>(VERSION);
+	file.WriteValue<uint64_t>(key);
+	file.Write(buf.GetPointer(), buf.GetSize());
+
+	return true;
+}
+unique_ptr<script_engine> ScriptBytecodeCache::Load(const std::wstring& path, uint64_t key,
+	const std::vector<function>& listFunc)
+{
+	ByteBuffer buf;
+	{
+		Lock lock(lock_);
+
+		File file(path);
+		if (!file.Open())
+			return nullptr;
+
+		size_t size = file.GetSize();
+		if (size < sizeof(HEADER) - 1 + sizeof(uint32_t) + sizeof(uint64_t))
+			return nullptr;
+
+		buf.SetSize(size);
+		file.Read(buf.GetPointer(), size);
+	}
+
+	if (memcmp(buf.GetPointer(), HEADER, sizeof(HEADER) - 1) != 0)
+		return nullptr;
+	buf.Seek(sizeof(HEADER) - 1);
+
+	unique_ptr<script_engine> engine(new script_engine());
+	try {
+		_BytecodeReader reader(buf);
+		if (reader.Read<uint32_t>() != VERSION || reader.Read<uint64_t>() != key)
+			return nullptr;
+
+		std::vector<const function*> listFuncTable = _GetFunctionTable(listFunc);
+
+		uint32_t countBlock = reader.Read<uint32_t>();
+		for (uint32_t iBlock = 0; iBlock < countBlock; ++iBlock) {
+			uint32_t level = reader.Read<uint32_t>();
+			uint32_t arguments = reader.Read<uint32_t>();
+			std::string name = reader.ReadString();
+			block_kind kind = (block_kind)reader.Read<uint8_t>();
+			int32_t indexFunc = reader.Read<int32_t>();
+
+			script_block* block = engine->new_block(level, kind);
+			block->arguments = arguments;
+			block->name = MOVE(name);
+			if (indexFunc >= 0) {
+				if ((size_t)indexFunc >= listFuncTable.size()) return nullptr;
+				block->func = listFuncTable[indexFunc]->func;
+			}
+			reader.AddBlock(block);
+		}
+
+		for (script_block& block : engine->blocks) {
+			uint32_t countCode = reader.Read<uint32_t>();
+			block.codes.reserve(countCode);
+			for (uint32_t iCode = 0; iCode < countCode; ++iCode) {
+				code c;
+				command_kind op = (command_kind)reader.Read<uint8_t>();
+				uint32_t line = reader.Read<uint32_t>();
+#ifdef _DEBUG
+				std::string varName = reader.ReadString();
+#endif
+
+				switch (op) {
+				case command_kind::pc_push_value:
+					c = code(op, reader.ReadValue());
+					break;
+				case command_kind::pc_call:
+				case command_kind::pc_call_and_push_result:
+				{
+					c = code(op);
+					c.block = reader.GetBlock(reader.Read<uint32_t>());
+					c.arg1 = reader.Read<uint32_t>();
+					break;
+				}
+				case command_kind::pc_inline_cast_var:
+				{
+					type_data* type = reader.ReadType();
+					c = code(op, (uint32_t)type, reader.Read<uint32_t>());
+					break;
+				}
+				default:
+				{
+					uint64_t arg0 = reader.Read<uint64_t>();
+					c = code(op, (uint32_t)arg0, reader.Read<uint32_t>());
+					break;
+				}
+				}
+				c.SetLine(line);
+#ifdef _DEBUG
+				c.var_name = MOVE(varName);
+#endif
+				block.codes.push_back(MOVE(c));
+			}
+		}
+
+		engine->main_block = reader.GetBlock(reader.Read<uint32_t>());
+		uint32_t countEvent = reader.Read<uint32_t>();
+		for (uint32_t iEvent = 0; iEvent < countEvent; ++iEvent) {
+			std::string name = reader.ReadString();
+			engine->events[name] = reader.GetBlock(reader.Read<uint32_t>());
+		}
+	}
+	catch (const _bytecode_error&) {
+		return nullptr;
+	}
+
+	return engine;
+}
+
 //****************************************************************************
 //ScriptClientBase
 //****************************************************************************
@@ -247,6 +713,7 @@ static const std::vector<constant> commonConstant = {
 };
 
 unique_ptr<script_type_manager> ScriptClientBase::pTypeManager_ = unique_ptr<script_type_manager>(new script_type_manager());
+std::wstring ScriptClientBase::pathBytecodeCache_ = L"";
 uint64_t ScriptClientBase::randCalls_ = 0;
 uint64_t ScriptClientBase::prandCalls_ = 0;
 ScriptClientBase::ScriptClientBase() {
@@ -356,22 +823,51 @@ std::vector<char> ScriptClientBase::_ParseScriptSource(std::vector<char>& source
 	return scriptLoader.GetResult();
 }
 bool ScriptClientBase::_CreateEngine() {
+	std::wstring pathCache;
+	uint64_t keyCache = 0;
+	if (pathBytecodeCache_.size() > 0) {
+		keyCache = ScriptBytecodeCache::ComputeKey(engineData_->GetPath(), engineData_->GetSource(),
+			engineData_->GetScriptFileLineMap(), func_, const_);
+		pathCache = ScriptBytecodeCache::GetCachePath(pathBytecodeCache_, engineData_->GetPath(), keyCache);
+
+		if (unique_ptr<script_engine> engine = ScriptBytecodeCache::Load(pathCache, keyCache, func_)) {
+			engineData_->SetEngine(std::move(engine));
+			return true;
+		}
+	}
+
 	unique_ptr<script_engine> engine(new script_engine(engineData_->GetSource(), &func_, &const_));
 	engineData_->SetEngine(std::move(engine));
-	return !engineData_->GetEngine()->get_error();
+
+	bool res = !engineData_->GetEngine()->get_error();
+	if (res && pathCache.size() > 0) {
+		if (ScriptBytecodeCache::Save(pathCache, keyCache, engineData_->GetEngine().get(), func_))
+			ScriptBytecodeCache::Prune(pathBytecodeCache_, engineData_->GetPath(), keyCache);
+	}
+	return res;
 }
 bool ScriptClientBase::SetSourceFromFile(std::wstring path) {
 	path = PathProperty::GetUnique(path);
 
-	if (auto pFindCache = cache_->GetCache(path)) {
-		engineData_ = pFindCache;
+	//A new entry stays locked until its source is read, other loads of the same file wait on it
+	std::optional<Lock> lockData;
+	{
+		Lock lock(cache_->GetLock());
+
+		if (auto pFindCache = cache_->GetCache(path)) {
+			engineData_ = pFindCache;
+		}
+		else {
+			// Script not found in cache, create a new entry
+			engineData_ = cache_->AddCache(path, make_unique<ScriptEngineData>());
+			engineData_->SetPath(path);
+			lockData.emplace(engineData_->GetLock());
+		}
+	}
+	if (!lockData) {
+		Lock lock(engineData_->GetLock());
 		return true;
 	}
-
-	// Script not found in cache, create a new entry
-
-	engineData_ = cache_->AddCache(path, make_unique<ScriptEngineData>());
-	engineData_->SetPath(path);
 	
 	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
 	if (reader == nullptr || !reader->Open())
@@ -399,14 +895,19 @@ void ScriptClientBase::SetSource(std::vector<char>& source) {
 	mapLine->AddEntry(engineData_->GetPath(), 1, StringUtility::CountCharacter(source, '\n') + 1);
 }
 void ScriptClientBase::Compile() {
-	if (engineData_->GetEngine() == nullptr) {
-		std::vector<char> source = _ParseScriptSource(engineData_->GetSource());
-		engineData_->SetSource(source);
+	{
+		//The engine may be shared with a script compiling on another thread
+		Lock lock(engineData_->GetLock());
 
-		bool bCreateSuccess = _CreateEngine();
-		if (!bCreateSuccess) {
-			bError_ = true;
-			_RaiseErrorFromEngine();
+		if (engineData_->GetEngine() == nullptr) {
+			std::vector<char> source = _ParseScriptSource(engineData_->GetSource());
+			engineData_->SetSource(source);
+
+			bool bCreateSuccess = _CreateEngine();
+			if (!bCreateSuccess) {
+				bError_ = true;
+				_RaiseErrorFromEngine();
+			}
 		}
 	}
 
@@ -834,9 +1335,9 @@ static value _ScriptValueLerp(script_machine* machine, const value* v1, const va
 			std::vector<value> resArr;
 			resArr.resize(v1->length_as_array());
 			for (size_t i = 0; i < v1->length_as_array(); ++i) {
-				const value* a1 = &(*v1)[i];
-				const value* a2 = &(*v2)[i];
-				resArr[i] = _ScriptValueLerp(machine, a1, a2, vx, lerpFunc);
+				value a1 = v1->array_get_value(i);
+				value a2 = v2->array_get_value(i);
+				resArr[i] = _ScriptValueLerp(machine, &a1, &a2, vx, lerpFunc);
 			}
 
 			res.reset(v1->get_type(), resArr);
@@ -998,7 +1499,7 @@ value ScriptClientBase::Func_Interpolate_X_Array(script_machine* machine, int ar
 		return value();
 	}
 
-	std::vector<value> arr = *(val->as_array_ptr());
+	std::vector<value> arr = val->as_array();
 	double x = argv[1].as_float();
 
 	size_t len = arr.size();
@@ -41,6 +41,8 @@ namespace gstd {
 	//*******************************************************************
 	class ScriptEngineData {
 	protected:
+		gstd::CriticalSection lock_;
+
 		std::wstring path_;
 
 		Encoding::Type encoding_;
@@ -63,6 +65,8 @@ namespace gstd {
 		unique_ptr<script_engine>& GetEngine() { return engine_; }
 
 		ScriptFileLineMap* GetScriptFileLineMap() { return &mapLine_; }
+
+		gstd::CriticalSection& GetLock() { return lock_; }
 	};
 
 	//*******************************************************************
@@ -70,6 +74,8 @@ namespace gstd {
 	//*******************************************************************
 	class ScriptEngineCache {
 	protected:
+		gstd::CriticalSection lock_;
+
 		std::map<std::wstring, uptr<ScriptEngineData>> cache_;
 	public:
 		ScriptEngineCache();
@@ -80,11 +86,39 @@ namespace gstd {
 		void RemoveCache(const std::wstring& name);
 		ScriptEngineData* GetCache(const std::wstring& name);
 
+		//Lock GetLock() while iterating, scripts may be added from the load workers
 		const std::map<std::wstring, uptr<ScriptEngineData>>& GetMap() { return cache_; }
+		gstd::CriticalSection& GetLock() { return lock_; }
 
 		bool IsExists(const std::wstring& name);
 	};
 
+	//*******************************************************************
+	//ScriptBytecodeCache
+	//*******************************************************************
+	//Compiled script_engine blocks saved to disk, keyed by a hash of the preprocessed source, its line map,
+	//	and the function and constant tables it was compiled against
+	class ScriptBytecodeCache {
+	public:
+		static constexpr const char HEADER[] = "DNHBCODE";
+		static constexpr uint32_t VERSION = 1;
+	private:
+		static gstd::CriticalSection lock_;
+	public:
+		static uint64_t ComputeKey(const std::wstring& path, const std::vector<char>& source, ScriptFileLineMap* mapLine,
+			const std::vector<function>& listFunc, const std::vector<constant>& listConst);
+
+		//Each script has one file in the cache directory, named after its path and its current key
+		static std::wstring GetCachePath(const std::wstring& dir, const std::wstring& pathScript, uint64_t key);
+		//Removes the script's files with an outdated key, and anything else not named like a cache file
+		static void Prune(const std::wstring& dir, const std::wstring& pathScript, uint64_t key);
+
+		static bool Save(const std::wstring& path, uint64_t key, script_engine* engine,
+			const std::vector<function>& listFunc);
+		static unique_ptr<script_engine> Load(const std::wstring& path, uint64_t key,
+			const std::vector<function>& listFunc);
+	};
+
 	//*******************************************************************
 	//ScriptClientBase
 	//*******************************************************************
@@ -92,6 +126,7 @@ namespace gstd {
 	class ScriptClientBase {
 		friend ScriptLoader;
 		static unique_ptr<script_type_manager> pTypeManager_;
+		static std::wstring pathBytecodeCache_;
 	public:
 		enum {
 			ID_SCRIPT_FREE = -1,
@@ -140,6 +175,10 @@ namespace gstd {
 
 		static script_type_manager* GetDefaultScriptTypeManager() { return pTypeManager_.get(); }
 
+		//Empty to disable the on-disk bytecode cache
+		static void SetBytecodeCacheDirectory(const std::wstring& dir) { pathBytecodeCache_ = dir; }
+		static const std::wstring& GetBytecodeCacheDirectory() { return pathBytecodeCache_; }
+
 		void SetScriptEngineCache(ScriptEngineCache* cache) { cache_ = cache; }
 		ScriptEngineCache* GetScriptEngineCache() { return cache_; }
 
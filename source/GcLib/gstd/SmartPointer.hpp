@@ -6,6 +6,15 @@
 #include "../pch.h"
 
 namespace gstd {
+	//Block storage for ref_count_ptr::CreateInPool
+	class ref_count_pool {
+	public:
+		virtual ~ref_count_pool() {}
+
+		virtual void* AllocateBlock() = 0;
+		virtual void FreeBlock(void* pBlock) noexcept = 0;
+	};
+
 	//Base for reference counting
 	template<class T, bool ATOMIC>
 	class _ptr_ref_counter {
@@ -13,6 +22,7 @@ namespace gstd {
 		uint32_t countRef_ = 0;		// Strong ref count, the managed pointer is deleted when this reaches 0
 		uint32_t countWeak_ = 0;	// Weak ref count, the counter is deleted when this reaches 0
 		T* pPtr_ = nullptr;			// Managed pointer, shouldn't be accessed from outside
+		ref_count_pool* pPool_ = nullptr;	// Set if this counter and the managed object share one block from a pool
 	public:
 		_ptr_ref_counter(T* src) noexcept {
 			pPtr_ = src;
@@ -21,12 +31,14 @@ namespace gstd {
 			countRef_ = other.countRef_;
 			countWeak_ = other.countWeak_;
 			pPtr_ = (T*)other.pPtr_;
+			pPool_ = other.pPool_;
 		}
 
 		_ptr_ref_counter& operator=(_ptr_ref_counter<T, ATOMIC>& other) noexcept {
 			countRef_ = other.countRef_;
 			countWeak_ = other.countWeak_;
 			pPtr_ = other.pPtr_;
+			pPool_ = other.pPool_;
 			return *this;
 		}
 		template<class U, bool ATOMIC_U>
@@ -34,6 +46,7 @@ namespace gstd {
 			countRef_ = other.countRef_;
 			countWeak_ = other.countWeak_;
 			pPtr_ = (T*)other.pPtr_;
+			pPool_ = other.pPool_;
 			return *this;
 		}
 
@@ -42,11 +55,21 @@ namespace gstd {
 		inline void DeleteResource() noexcept {	// Deletes managed pointer
 			if constexpr (std::is_array_v<T>)
 				ptr_delete_scalar(pPtr_);
+			else if (pPool_) {
+				//Only destroyed here, the memory goes back to the pool with the counter
+				if (pPtr_) pPtr_->~T();
+				pPtr_ = nullptr;
+			}
 			else
 				ptr_delete(pPtr_);
 		}
 		inline void DeleteSelf() noexcept {		// Deletes [this]
-			delete this;
+			if (ref_count_pool* pPool = pPool_) {
+				this->~_ptr_ref_counter();
+				pPool->FreeBlock(this);
+			}
+			else
+				delete this;
 		}
 
 		inline void AddRef() noexcept {
@@ -219,6 +242,33 @@ namespace gstd {
 			}
 			return res;
 		}
+
+		//----------------------------------------------------------------------
+
+		static constexpr size_t POOL_OBJECT_OFFSET = (sizeof(_MyCounter) + alignof(T) - 1) / alignof(T) * alignof(T);
+		static constexpr size_t GetPoolBlockSize() { return POOL_OBJECT_OFFSET + sizeof(T); }
+
+		//Constructs the counter and the object together in one block of at least GetPoolBlockSize() bytes, like std::allocate_shared.
+		//	The object is destroyed with the last strong reference, the block is given back with the last weak one.
+		template<class... Args> static _MyType CreateInPool(ref_count_pool* pool, Args&&... args) {
+			uint8_t* pBlock = (uint8_t*)pool->AllocateBlock();
+
+			T* pObject = nullptr;
+			try {
+				pObject = ::new (pBlock + POOL_OBJECT_OFFSET) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				pool->FreeBlock(pBlock);
+				throw;
+			}
+
+			_MyCounter* pInfo = ::new (pBlock) _MyCounter(pObject);
+			pInfo->pPool_ = pool;
+
+			_MyType res;
+			res._SetPointerFromInfo<T>(pInfo, pObject);
+			return res;
+		}
 	};
 
 	// A non-atomic smart pointer (weak ref)
@@ -134,3 +134,141 @@ void ThreadSignal::SetSignal(bool bOn) {
 	else
 		::ResetEvent(hEvent_);
 }
+
+//*******************************************************************
+//JobSystem
+//*******************************************************************
+thread_local size_t JobSystem::indexThreadQueue_ = SIZE_MAX;
+JobSystem::JobSystem(size_t countWorker) {
+	countQueued_ = 0;
+	bStop_ = false;
+
+	for (size_t i = 0; i <= countWorker; ++i)
+		listQueue_.push_back(make_unique<JobQueue>());
+	for (size_t i = 0; i < countWorker; ++i) {
+		listThread_.push_back(make_unique<WorkerThread>(this, i));
+		listThread_.back()->Start();
+	}
+}
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(lockSleep_);
+		bStop_ = true;
+	}
+	signalSleep_.notify_all();
+
+	for (auto& thread : listThread_)
+		thread->Join();
+}
+JobSystem* JobSystem::GetBase() {
+	static JobSystem instance(std::max(std::thread::hardware_concurrency(), 1U) - 1U);
+	return &instance;
+}
+size_t JobSystem::_GetThreadQueueIndex() {
+	//Threads outside the pool share the last queue
+	return indexThreadQueue_ < listThread_.size() ? indexThreadQueue_ : listThread_.size();
+}
+void JobSystem::_Submit(void (*func)(void*, size_t), void* data, size_t begin, size_t end, Batch* batch) {
+	//Counted first so it never drops below the number of queued jobs
+	countQueued_ += end - begin;
+	{
+		JobQueue* queue = listQueue_[_GetThreadQueueIndex()].get();
+		std::lock_guard<std::mutex> lock(queue->lock);
+		for (size_t i = begin; i < end; ++i)
+			queue->listJob.push_back({ func, data, i, batch });
+	}
+
+	//Taking the lock orders this against a worker checking countQueued_ before it sleeps
+	{
+		std::lock_guard<std::mutex> lock(lockSleep_);
+	}
+	signalSleep_.notify_all();
+}
+bool JobSystem::_PopJob(size_t indexQueue, Job* res) {
+	if (countQueued_ == 0) return false;
+
+	//Own queue from the back, the newest and likely still in cache, other queues from the front
+	size_t countQueue = listQueue_.size();
+	for (size_t i = 0; i < countQueue; ++i) {
+		JobQueue* queue = listQueue_[(indexQueue + i) % countQueue].get();
+		std::lock_guard<std::mutex> lock(queue->lock);
+		if (queue->listJob.empty()) continue;
+
+		if (i == 0) {
+			*res = queue->listJob.back();
+			queue->listJob.pop_back();
+		}
+		else {
+			*res = queue->listJob.front();
+			queue->listJob.pop_front();
+		}
+		--countQueued_;
+		return true;
+	}
+	return false;
+}
+bool JobSystem::_PopBatchJob(size_t indexQueue, Batch* batch, Job* res) {
+	if (countQueued_ == 0) return false;
+
+	//A batch is pushed under one lock, so its remaining jobs sit next to each other
+	JobQueue* queue = listQueue_[indexQueue].get();
+	std::lock_guard<std::mutex> lock(queue->lock);
+	for (auto itr = queue->listJob.rbegin(); itr != queue->listJob.rend(); ++itr) {
+		if (itr->batch != batch) continue;
+
+		*res = *itr;
+		queue->listJob.erase(std::next(itr).base());
+		--countQueued_;
+		return true;
+	}
+	return false;
+}
+void JobSystem::_RunJob(const Job& job) {
+	Batch* batch = job.batch;
+	try {
+		job.func(job.data, job.index);
+	}
+	catch (...) {
+		//Written before the count drops, the waiter reads it only after seeing zero
+		if (!batch->bError.exchange(true, std::memory_order_relaxed))
+			batch->error = std::current_exception();
+	}
+	batch->countPending.fetch_sub(1, std::memory_order_acq_rel);
+}
+void JobSystem::_Wait(Batch* batch) {
+	size_t indexQueue = _GetThreadQueueIndex();
+
+	//Workers help with anything, outside threads share a queue and only take their own jobs from it
+	bool bWorker = indexQueue < listThread_.size();
+	while (batch->countPending.load(std::memory_order_acquire) > 0) {
+		Job job;
+		bool bPop = bWorker ? _PopJob(indexQueue, &job) : _PopBatchJob(indexQueue, batch, &job);
+		if (bPop)
+			_RunJob(job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+//JobSystem::WorkerThread
+JobSystem::WorkerThread::WorkerThread(JobSystem* system, size_t index) {
+	system_ = system;
+	index_ = index;
+}
+JobSystem::WorkerThread::~WorkerThread() {}
+void JobSystem::WorkerThread::_Run() {
+	indexThreadQueue_ = index_;
+
+	while (!system_->bStop_) {
+		Job job;
+		if (system_->_PopJob(index_, &job)) {
+			system_->_RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(system_->lockSleep_);
+		system_->signalSleep_.wait(lock, [&]() {
+			return system_->bStop_ || system_->countQueued_ > 0;
+		});
+	}
+}
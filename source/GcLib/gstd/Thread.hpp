@@ -86,4 +86,107 @@ namespace gstd {
 		DWORD Wait(int mills = INFINITE);
 		void SetSignal(bool bOn = true);
 	};
+
+	//****************************************************************************
+	//JobSystem
+	//	Persistent worker threads for short parallel loops
+	//	Every worker owns a job queue and steals from the other queues once its own is empty.
+	//	A thread waiting on its jobs runs queued jobs instead of blocking, so jobs may submit and wait on more jobs.
+	//	Threads outside the pool only run jobs of the Run they are waiting on, so one never ends up
+	//	stuck inside a long job submitted by another outside thread.
+	//****************************************************************************
+	class JobSystem {
+	public:
+		//Jobs of a single Run
+		struct Batch {
+			std::atomic<size_t> countPending;
+			std::atomic<bool> bError;
+			std::exception_ptr error;		//First exception thrown by a job, set once bError is taken
+
+			Batch(size_t count) : countPending(count), bError(false) {}
+		};
+		struct Job {
+			void (*func)(void* data, size_t index);
+			void* data;
+			size_t index;
+			Batch* batch;
+		};
+	private:
+		class WorkerThread;
+
+		struct JobQueue {
+			std::mutex lock;
+			std::deque<Job> listJob;
+		};
+
+		static thread_local size_t indexThreadQueue_;
+
+		std::vector<unique_ptr<WorkerThread>> listThread_;
+		std::vector<unique_ptr<JobQueue>> listQueue_;	//One per worker, the last one is shared by all other threads
+
+		std::atomic<size_t> countQueued_;
+		std::atomic<bool> bStop_;
+		std::mutex lockSleep_;
+		std::condition_variable signalSleep_;
+
+		size_t _GetThreadQueueIndex();
+		void _Submit(void (*func)(void*, size_t), void* data, size_t begin, size_t end, Batch* batch);
+		bool _PopJob(size_t indexQueue, Job* res);
+		bool _PopBatchJob(size_t indexQueue, Batch* batch, Job* res);
+		void _RunJob(const Job& job);
+		void _Wait(Batch* batch);
+	public:
+		JobSystem(size_t countWorker);
+		~JobSystem();
+
+		//Created on first use, with one worker less than the core count as the calling thread works too
+		static JobSystem* GetBase();
+
+		size_t GetWorkerCount() { return listThread_.size(); }
+
+		//Calls func(index) for every index in [0, count) and returns once all calls have finished
+		//If any call throws, the first exception is rethrown here after the rest have finished
+		template<class F> void Run(size_t count, F&& func);
+	};
+
+	class JobSystem::WorkerThread : public Thread {
+		JobSystem* system_;
+		size_t index_;
+	protected:
+		virtual void _Run();
+	public:
+		WorkerThread(JobSystem* system, size_t index);
+		virtual ~WorkerThread();
+	};
+
+	template<class F>
+	void JobSystem::Run(size_t count, F&& func) {
+		if (count == 0) return;
+		if (count == 1 || listThread_.size() == 0) {
+			for (size_t i = 0; i < count; ++i)
+				func(i);
+			return;
+		}
+
+		using FuncType = std::remove_reference_t<F>;
+		auto _Invoke = [](void* data, size_t index) {
+			(*(FuncType*)data)(index);
+		};
+
+		//Index 0 runs here right away, the rest goes to the queues
+		Batch batch(count - 1);
+		_Submit(_Invoke, (void*)std::addressof(func), 1, count, &batch);
+		try {
+			func(0);
+		}
+		catch (...) {
+			//The queued jobs still point into this frame
+			_Wait(&batch);
+			throw;
+		}
+		_Wait(&batch);
+
+		if (batch.error)
+			std::rethrow_exception(batch.error);
+	}
 }
\ No newline at end of file
@@ -124,14 +124,17 @@
 
 #include <array>
 #include <list>
+#include <deque>
 #include <vector>
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <any>
 #include <bitset>
 #include <complex>
 #include <optional>
+#include <variant>
 
 #include <memory>
 #include <algorithm>
@@ -146,6 +149,8 @@
 #include <sstream>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
 
 #include <regex>
 
@@ -194,6 +199,11 @@
 
 namespace stdch = std::chrono;
 
+// Use computed goto dispatch in the script interpreter, MSVC stays on the switch
+#if defined(__GNUC__) || defined(__clang__)
+	#define __L_SCRIPT_THREADED_DISPATCH
+#endif
+
 //------------------------------------------------------------------------------
 
 #include "Types.hpp"
@@ -64,6 +64,10 @@ DnhConfiguration::DnhConfiguration() {
 
 	bEnableUnfocusedProcessing_ = false;
 
+	replayStateHashInterval_ = 60;
+
+	bHeadless_ = false;
+
 	LoadConfigFile();
 	_LoadDefinitionFile();
 }
@@ -98,6 +102,8 @@ bool DnhConfiguration::_LoadDefinitionFile() {
 		bEnableUnfocusedProcessing_ = str == L"true" ? true : StringUtility::ToInteger(str);
 	}
 
+	replayStateHashInterval_ = std::max(prop.GetInteger(L"replay.hash.interval", 60), 0);
+
 	{
 		auto _AddWindowSize = [&](std::vector<POINT>& listSize, LONG width, LONG height) {
 			POINT size = {
@@ -55,6 +55,10 @@ public:
 
 	std::wstring pathPackageScript_;
 
+	uint32_t replayStateHashInterval_;	//Frames between the state hashes recorded into replays, 0 to record none
+
+	bool bHeadless_;	//Set by the -headless command line option, never saved
+
 	bool _LoadDefinitionFile();
 public:
 	DnhConfiguration();
@@ -6,6 +6,40 @@
 
 #include "../../GcLib/gstd/CompressorStream.hpp"
 
+//*******************************************************************
+//ReplayStateHash
+//*******************************************************************
+uint64_t ReplayStateHash::Combine() const {
+	uint64_t res = 0;
+	for (size_t i = 0; i < COUNT; ++i)
+		res = (res ^ hash[i]) * 0x100000001b3ULL;
+	return res;
+}
+uint32_t ReplayStateHash::Compare(const ReplayStateHash& other) const {
+	uint32_t mask = 0;
+	for (size_t i = 0; i < COUNT; ++i) {
+		if (hash[i] != other.hash[i])
+			mask |= 1U << i;
+	}
+	return mask;
+}
+const char* ReplayStateHash::GetPartName(size_t part) {
+	static const char* listName[COUNT] = {
+		"stage", "rand", "player", "shot", "enemy", "item", "common data",
+	};
+	return part < COUNT ? listName[part] : "";
+}
+std::string ReplayStateHash::GetPartNames(uint32_t mask) {
+	std::string res;
+	for (size_t i = 0; i < COUNT; ++i) {
+		if ((mask & (1U << i)) == 0) continue;
+		if (res.size() > 0)
+			res += ", ";
+		res += GetPartName(i);
+	}
+	return res;
+}
+
 //*******************************************************************
 //ReplayInformation
 //*******************************************************************
@@ -248,6 +282,12 @@ void ReplayInformation::StageData::SetCommonData(
 	mapCommonData_[area] = MOVE(record);
 }
 
+const ReplayStateHash* ReplayInformation::StageData::GetStateHash(DWORD frame) {
+	if (stateHashInterval_ == 0 || frame % stateHashInterval_ != 0) return nullptr;
+	size_t index = frame / stateHashInterval_;
+	return index < listStateHash_.size() ? &listStateHash_[index] : nullptr;
+}
+
 void ReplayInformation::StageData::ReadRecord(gstd::RecordBuffer& record) {
 	mainScriptID_ = *record.GetRecordAsStringW("mainScriptID");
 	mainScriptName_ = *record.GetRecordAsStringW("mainScriptName");
@@ -275,6 +315,16 @@ void ReplayInformation::StageData::ReadRecord(gstd::RecordBuffer& record) {
 		}
 	}
 
+	//State hashes, absent in replays from older versions
+	stateHashInterval_ = record.GetRecordOr<uint32_t>("stateHashInterval", 0);
+	listStateHash_.clear();
+	if (stateHashInterval_ > 0) {
+		size_t countStateHash = record.GetRecordOr<uint32_t>("countStateHash", 0);
+		listStateHash_.resize(countStateHash);
+		if (countStateHash > 0)
+			record.GetRecord("listStateHash", &listStateHash_[0], sizeof(ReplayStateHash) * countStateHash);
+	}
+
 	//Player information
 	playerScriptID_ = *record.GetRecordAsStringW("playerScriptID");
 	playerScriptFileName_ = *record.GetRecordAsStringW("playerScriptFileName");
@@ -313,6 +363,13 @@ void ReplayInformation::StageData::WriteRecord(gstd::RecordBuffer& record) {
 		record.SetRecordAsRecordBuffer("mapCommonData", recComMap);
 	}
 
+	//State hashes
+	if (stateHashInterval_ > 0 && listStateHash_.size() > 0) {
+		record.SetRecord<uint32_t>("stateHashInterval", stateHashInterval_);
+		record.SetRecord<uint32_t>("countStateHash", listStateHash_.size());
+		record.SetRecord("listStateHash", &listStateHash_[0], sizeof(ReplayStateHash) * listStateHash_.size());
+	}
+
 	//Player information
 	record.SetRecordAsStringW("playerScriptID", playerScriptID_);
 	record.SetRecordAsStringW("playerScriptFileName", playerScriptFileName_);
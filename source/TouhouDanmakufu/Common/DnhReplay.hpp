@@ -4,6 +4,33 @@
 
 #include "DnhCommon.hpp"
 
+//*******************************************************************
+//ReplayStateHash
+//	Hash of each part of the simulation state at one frame
+//	Recorded into the replay every few frames, playback compares them to find where a desync started
+//*******************************************************************
+struct ReplayStateHash {
+	enum : uint8_t {
+		STAGE,			//Frame, score, graze and point
+		RAND,
+		PLAYER,
+		SHOT,
+		ENEMY,
+		ITEM,
+		COMMON_DATA,
+
+		COUNT,
+	};
+
+	uint64_t hash[COUNT];
+
+	uint64_t Combine() const;
+	uint32_t Compare(const ReplayStateHash& other) const;	//Bit mask of the parts that differ
+
+	static const char* GetPartName(size_t part);
+	static std::string GetPartNames(uint32_t mask);
+};
+
 //*******************************************************************
 //ReplayInformation
 //*******************************************************************
@@ -87,6 +114,9 @@ private:
 	gstd::RecordBuffer recordKey_;
 	std::map<std::string, gstd::RecordBuffer> mapCommonData_;
 
+	uint32_t stateHashInterval_ = 0;	//In frames, 0 if the replay has no state hashes
+	std::vector<ReplayStateHash> listStateHash_;
+
 	std::wstring playerScriptID_;
 	std::wstring playerScriptFileName_;
 	std::wstring playerScriptReplayName_;
@@ -130,6 +160,11 @@ public:
 		SetCommonData(area, commonData.get());
 	}
 
+	uint32_t GetStateHashInterval() { return stateHashInterval_; }
+	void SetStateHashInterval(uint32_t interval) { stateHashInterval_ = interval; }
+	const ReplayStateHash* GetStateHash(DWORD frame);
+	void AddStateHash(const ReplayStateHash& hash) { listStateHash_.push_back(hash); }
+
 	std::wstring& GetPlayerScriptID() { return playerScriptID_; }
 	void SetPlayerScriptID(const std::wstring& id) { playerScriptID_ = id; }
 	std::wstring& GetPlayerScriptFileName() { return playerScriptFileName_; }
@@ -73,6 +73,17 @@ void StgMoveObject::_AttachReservedPattern(ref_unsync_ptr<StgMovePattern> patter
 	pattern->Activate(pattern_.get());
 	pattern_ = pattern;
 }
+void StgMoveObject::GetPendingPatternRelativeObjects(std::vector<StgMoveObject*>* listRes) {
+	if (!bEnableMovement_) return;
+
+	//Same range as _Move
+	for (auto itr = mapPattern_.begin(); itr != mapPattern_.end() && framePattern_ >= itr->first; ++itr) {
+		for (auto& ipPattern : itr->second) {
+			if (StgMoveObject* objRelative = ipPattern->GetActivateRelativeObject())
+				listRes->push_back(objRelative);
+		}
+	}
+}
 void StgMoveObject::AddPattern(uint32_t frameDelay, ref_unsync_ptr<StgMovePattern> pattern, bool bForceMap) {
 	if (frameDelay == 0 && !bForceMap)
 		_AttachReservedPattern(pattern);
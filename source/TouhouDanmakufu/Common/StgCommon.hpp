@@ -36,6 +36,11 @@ protected:
 
 	virtual void _Move();
 	void _AttachReservedPattern(ref_unsync_ptr<StgMovePattern> pattern);
+
+	//Whether the next _Move will attach a reserved pattern or create the default one
+	bool _IsPatternAttachPending() {
+		return !mapPattern_.empty() && (pattern_ == nullptr || framePattern_ >= mapPattern_.begin()->first);
+	}
 public:
 	StgMoveObject(StgStageController* stageController);
 	virtual ~StgMoveObject();
@@ -63,6 +68,8 @@ public:
 		pattern_ = pattern;
 	}
 	void AddPattern(uint32_t frameDelay, ref_unsync_ptr<StgMovePattern> pattern, bool bForceMap = false);
+	//Adds the objects whose positions are read when the next _Move attaches its reserved patterns
+	void GetPendingPatternRelativeObjects(std::vector<StgMoveObject*>* listRes);
 
 	int GetMoveFrame() { return frameMove_; }
 };
@@ -112,6 +119,9 @@ public:
 	virtual void Activate(StgMovePattern* src) {}
 	virtual void Move() = 0;
 
+	//Other object whose position Activate reads
+	virtual StgMoveObject* GetActivateRelativeObject() { return nullptr; }
+
 	void AddCommand(std::pair<uint8_t, double> cmd) { listCommand_.push_back(cmd); }
 	int GetType() { return typeMove_; }
 
@@ -168,6 +178,8 @@ public:
 	virtual void Activate(StgMovePattern* src);
 	virtual void Move();
 
+	virtual StgMoveObject* GetActivateRelativeObject() { return objRelative_.get(); }
+
 	virtual inline double GetSpeed() { return speed_; }
 	// virtual inline double GetDirectionAngle() { return angDirection_; }
 
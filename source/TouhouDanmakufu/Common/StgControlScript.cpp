@@ -91,6 +91,9 @@ static const std::vector<function> stgControlFunction = {
 	{ "AddPoint", StgControlScript::Func_StgStageInformation_void_int64<&StgStageInformation::AddPoint>, 1 },
 
 	{ "IsReplay", StgControlScript::Func_IsReplay, 0 },
+	{ "SetReplaySpeed", StgControlScript::Func_SetReplaySpeed, 1 },
+	{ "SeekReplay", StgControlScript::Func_SeekReplay, 1 },
+	{ "IsReplaySeeking", StgControlScript::Func_IsReplaySeeking, 0 },
 
 	{ "AddArchiveFile", StgControlScript::Func_AddArchiveFile, 1 },
 	{ "AddArchiveFile", StgControlScript::Func_AddArchiveFile, 2 },		//Overloaded
@@ -670,6 +673,29 @@ gstd::value StgControlScript::Func_IsReplay(gstd::script_machine* machine, int a
 
 	return script->CreateBooleanValue(res);
 }
+gstd::value StgControlScript::Func_SetReplaySpeed(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgControlScript* script = (StgControlScript*)machine->data;
+	int64_t speed = argv[0].as_int();
+	script->systemController_->SetReplaySpeed(std::max<int64_t>(speed, 1));
+	return value();
+}
+gstd::value StgControlScript::Func_SeekReplay(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgControlScript* script = (StgControlScript*)machine->data;
+	int64_t frame = argv[0].as_int();
+	script->systemController_->SeekReplay(std::max<int64_t>(frame, 0));
+	return value();
+}
+gstd::value StgControlScript::Func_IsReplaySeeking(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgControlScript* script = (StgControlScript*)machine->data;
+
+	bool res = false;
+
+	StgStageController* stageController = script->systemController_->GetStageController();
+	if (stageController)
+		res = stageController->IsReplaySeeking();
+
+	return script->CreateBooleanValue(res);
+}
 gstd::value StgControlScript::Func_AddArchiveFile(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	FileManager* fileManager = FileManager::GetBase();
 	std::wstring path = argv[0].as_string();
@@ -1462,6 +1488,7 @@ void ScriptInfoPanel::Update() {
 		for (auto& task : listTask) {
 			if (const auto& systemController = dptr_cast(StgSystemController, task)) {
 				{
+					Lock lockCache(systemController->GetScriptEngineCache()->GetLock());
 					auto& pCacheMap = systemController->GetScriptEngineCache()->GetMap();
 
 					for (auto& [path, pCacheData] : pCacheMap) {
@@ -128,6 +128,9 @@ public:
 	DNH_FUNCAPI_DECL_(Func_StgStageInformation_void_int64);
 
 	static gstd::value Func_IsReplay(gstd::script_machine* machine, int argc, const gstd::value* argv);
+	DNH_FUNCAPI_DECL_(Func_SetReplaySpeed);
+	DNH_FUNCAPI_DECL_(Func_SeekReplay);
+	DNH_FUNCAPI_DECL_(Func_IsReplaySeeking);
 
 	static gstd::value Func_AddArchiveFile(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	DNH_FUNCAPI_DECL_(Func_GetArchiveFilePathList);
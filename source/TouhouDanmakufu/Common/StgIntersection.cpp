@@ -14,6 +14,8 @@ StgIntersectionManager::StgIntersectionManager() {
 	LONG screenWidth = graphics->GetScreenWidth();
 	LONG screenHeight = graphics->GetScreenHeight();
 
+	modeBroadphase_ = BROADPHASE_GRID;
+
 	//_CreatePool(2);
 	listSpace_.resize(3);
 	for (size_t iSpace = 0; iSpace < listSpace_.size(); iSpace++) {
@@ -125,39 +127,54 @@ void StgIntersectionManager::Work() {
 
 	size_t totalCheck = 0;
 	size_t totalTarget = 0;
+
+	stdch::duration<double, std::milli> timeBroad(0), timeNarrow(0), timeApply(0);
 	for (auto itr = listSpace_.begin(); itr != listSpace_.end(); itr++) {
 		StgIntersectionSpace* space = *itr;
 
+		auto timeStart = SystemUtility::GetCpuTime();
+
 		size_t currentCheck = 0;
 		auto listCheck = space->CreateIntersectionCheckList(this, currentCheck);
 
+		auto timeBroadEnd = SystemUtility::GetCpuTime();
+
+		//Pure geometric tests, no shared state is touched here
+		space->TestIntersectionCheckList(currentCheck, listHitCheck_);
+
+		auto timeNarrowEnd = SystemUtility::GetCpuTime();
+
+		//Callbacks, serially and in the original pair order
 		for (size_t iCheck = 0; iCheck < currentCheck; iCheck++) {
-			auto& cTargetPair = listCheck->at(iCheck);
+			if (!listHitCheck_[iCheck]) continue;
 
+			auto& cTargetPair = listCheck->at(iCheck);
 			StgIntersectionTarget* targetA = cTargetPair.first;
 			StgIntersectionTarget* targetB = cTargetPair.second;
-			if (targetA == nullptr || targetB == nullptr) continue;
 
-			if (IsIntersected(targetA, targetB)) {
-				const ref_unsync_weak_ptr<StgIntersectionObject>& ptrA = targetA->GetObject();
-				const ref_unsync_weak_ptr<StgIntersectionObject>& ptrB = targetB->GetObject();
-				{
-					if (ptrA) {
-						ptrA->Intersect(targetA, targetB);
-						ptrA->SetIntersected();
-						if (ptrB)
-							ptrA->AddIntersectedId(ptrB);
-					}
-					if (ptrB) {
-						ptrB->Intersect(targetB, targetA);
-						ptrB->SetIntersected();
-						if (ptrA)
-							ptrB->AddIntersectedId(ptrA);
-					}
+			const ref_unsync_weak_ptr<StgIntersectionObject>& ptrA = targetA->GetObject();
+			const ref_unsync_weak_ptr<StgIntersectionObject>& ptrB = targetB->GetObject();
+			{
+				if (ptrA) {
+					ptrA->Intersect(targetA, targetB);
+					ptrA->SetIntersected();
+					if (ptrB)
+						ptrA->AddIntersectedId(ptrB);
+				}
+				if (ptrB) {
+					ptrB->Intersect(targetB, targetA);
+					ptrB->SetIntersected();
+					if (ptrA)
+						ptrB->AddIntersectedId(ptrA);
 				}
 			}
 		}
 
+		auto timeApplyEnd = SystemUtility::GetCpuTime();
+		timeBroad += timeBroadEnd - timeStart;
+		timeNarrow += timeNarrowEnd - timeBroadEnd;
+		timeApply += timeApplyEnd - timeNarrowEnd;
+
 		totalCheck += currentCheck;
 		space->ClearTarget();
 	}
@@ -173,7 +190,11 @@ void StgIntersectionManager::Work() {
 			StringUtility::Format(L"Used=%4d, Cached=%4d, Total=%4d, Check=%4d", countUsed, countCache, countUsed + countCache, totalCheck));
 		*/
 		infoLog->SetInfo(9, "Intersection count",
-			StringUtility::Format("Total=%4d, Check=%4d", totalTarget, totalCheck));
+			StringUtility::Format("Total=%4d, Check=%4d, Broadphase=%s", totalTarget, totalCheck,
+				modeBroadphase_ == BROADPHASE_GRID ? "Grid" : "AllPairs"));
+		infoLog->SetInfo(10, "Intersection time",
+			StringUtility::Format("Broad=%.3fms, Narrow=%.3fms, Apply=%.3fms", 
+				timeBroad.count(), timeNarrow.count(), timeApply.count()));
 	}
 }
 void StgIntersectionManager::RenderVisualizer() {
@@ -444,12 +465,25 @@ ref_unsync_ptr<StgIntersectionTarget> StgIntersectionCheckList::GetTargetB(size_
 StgIntersectionSpace::StgIntersectionSpace() {
 	spaceRect_ = DxRect<double>(0, 0, 0, 0);
 	previousCheckCreated_ = 0;
+
+	gridLeft_ = 0;
+	gridTop_ = 0;
+	gridWidth_ = 1;
+	gridHeight_ = 1;
 }
 StgIntersectionSpace::~StgIntersectionSpace() {
 }
 bool StgIntersectionSpace::Initialize(double left, double top, double right, double bottom) {
 	spaceRect_ = DxRect<double>(left, top, right, bottom);
 	pooledCheckList_.resize(64U);
+
+	gridLeft_ = (LONG)floor(left);
+	gridTop_ = (LONG)floor(top);
+	gridWidth_ = std::max<LONG>((LONG)ceil(right - left) / GRID_CELL_SIZE + 1, 1);
+	gridHeight_ = std::max<LONG>((LONG)ceil(bottom - top) / GRID_CELL_SIZE + 1, 1);
+	gridCellStart_.resize(gridWidth_ * gridHeight_ + 1U);
+	gridCellFill_.resize(gridWidth_ * gridHeight_);
+
 	return true;
 }
 bool StgIntersectionSpace::RegistTarget(ListTarget* pVec, ref_unsync_ptr<StgIntersectionTarget>& target) {
@@ -468,15 +502,42 @@ void StgIntersectionSpace::ClearTarget() {
 	}
 }
 
+void StgIntersectionSpace::_BuildGrid(ListTarget* pListTarget) {
+	const size_t countCell = gridWidth_ * gridHeight_;
+	const size_t countTarget = pListTarget->size();
+
+	std::fill(gridCellStart_.begin(), gridCellStart_.end(), 0U);
+	gridTargetCell_.resize(countTarget);
+
+	//Count the entries of each cell, a target is entered into every cell its rect touches
+	for (size_t iTarget = 0; iTarget < countTarget; ++iTarget) {
+		DxRect<LONG> cellRange = _GetCellRange(pListTarget->at(iTarget)->GetIntersectionSpaceRect());
+		for (LONG cy = cellRange.top; cy <= cellRange.bottom; ++cy) {
+			for (LONG cx = cellRange.left; cx <= cellRange.right; ++cx)
+				++gridCellStart_[cy * gridWidth_ + cx + 1];
+		}
+		gridTargetCell_[iTarget] = cellRange;
+	}
+	for (size_t iCell = 1; iCell <= countCell; ++iCell)
+		gridCellStart_[iCell] += gridCellStart_[iCell - 1];
+
+	gridCellTarget_.resize(gridCellStart_[countCell]);
+	std::copy(gridCellStart_.begin(), gridCellStart_.begin() + countCell, gridCellFill_.begin());
+
+	for (size_t iTarget = 0; iTarget < countTarget; ++iTarget) {
+		const DxRect<LONG>& cellRange = gridTargetCell_[iTarget];
+		for (LONG cy = cellRange.top; cy <= cellRange.bottom; ++cy) {
+			for (LONG cx = cellRange.left; cx <= cellRange.right; ++cx)
+				gridCellTarget_[gridCellFill_[cy * gridWidth_ + cx]++] = iTarget;
+		}
+	}
+}
 std::vector<StgIntersectionSpace::TargetCheckListPair>* StgIntersectionSpace::CreateIntersectionCheckList(
 	StgIntersectionManager* manager, size_t& total) 
 {
 	ListTarget* pListTargetA = &pairTargetList_.first;
 	ListTarget* pListTargetB = &pairTargetList_.second;
 
-	CriticalSection& criticalSection = manager->GetLock();
-	std::atomic_uint count = 0;
-
 	if (manager->IsEnableVisualizer()) {
 		/*
 		ParallelFor(pListTargetA->size(), [&](size_t i) {
@@ -492,56 +553,215 @@ std::vector<StgIntersectionSpace::TargetCheckListPair>* StgIntersectionSpace::Cr
 			manager->AddVisualization(pTarget);
 	}
 
+	size_t count = 0;
 	if (pListTargetA->size() > 0 && pListTargetB->size() > 0) {
-		auto CheckSpaceRect = [&](StgIntersectionTarget* targetA, StgIntersectionTarget* targetB) {
+		auto CheckSpaceRect = [&](std::vector<TargetCheckListPair>& listCheck, size_t iA, size_t iB) {
+			StgIntersectionTarget* targetA = pListTargetA->at(iA).get();
+			StgIntersectionTarget* targetB = pListTargetB->at(iB).get();
 			if (targetA == nullptr || targetB == nullptr) return;
 			const DxRect<LONG>& boundA = targetA->GetIntersectionSpaceRect();
 			const DxRect<LONG>& boundB = targetB->GetIntersectionSpaceRect();
-			if (boundA.IsIntersected(boundB)) {
-				Lock lock(criticalSection);
-				if ((size_t)count >= pooledCheckList_.size()) {
-					pooledCheckList_.resize(pooledCheckList_.size() * 2);
-				}
-				pooledCheckList_[count.load()] = std::make_pair(targetA, targetB);
-				++count;
-			}
+			if (boundA.IsIntersected(boundB))
+				listCheck.push_back({ targetA, targetB, (uint32_t)iA, (uint32_t)iB });
 		};
 
-		//Attempt to most efficiently utilize multithreading
-		if (pListTargetA->size() >= pListTargetB->size()) {
-			ParallelFor(pListTargetA->size(), [&](size_t iA) {
-				StgIntersectionTarget* pTargetA = pListTargetA->at(iA).get();
-				for (auto itrB = pListTargetB->begin(); itrB != pListTargetB->end(); ++itrB) {
-					StgIntersectionTarget* pTargetB = itrB->get();
-					CheckSpaceRect(pTargetA, pTargetB);
+		poolCircleA_.Fill(*pListTargetA);
+		poolCircleB_.Fill(*pListTargetB);
+
+		//Each chunk writes into its own buffer, chunks cover contiguous ascending ranges,
+		//	so concatenating them in chunk order gives the same list no matter the core count
+		//Attempt to most efficiently utilize multithreading, the loop runs over the larger list
+		bool bLoopA = pListTargetA->size() >= pListTargetB->size();
+		size_t countLoop = bLoopA ? pListTargetA->size() : pListTargetB->size();
+
+		size_t countChunk = GetParallelChunkCount(countLoop);
+		if (listChunkCheckList_.size() < countChunk)
+			listChunkCheckList_.resize(countChunk);
+
+		if (manager->GetBroadphaseMode() == StgIntersectionManager::BROADPHASE_GRID) {
+			//The grid is built from the smaller list, and the larger one is looked up in it
+			ListTarget* pListLoop = bLoopA ? pListTargetA : pListTargetB;
+			ListTarget* pListGrid = bLoopA ? pListTargetB : pListTargetA;
+			_BuildGrid(pListGrid);
+
+			ParallelForChunk(countLoop, [&](size_t iChunk, size_t begin, size_t end) {
+				std::vector<TargetCheckListPair>& listCheck = listChunkCheckList_[iChunk];
+				listCheck.clear();
+
+				for (size_t iLoop = begin; iLoop < end; ++iLoop) {
+					StgIntersectionTarget* pTargetLoop = pListLoop->at(iLoop).get();
+					const DxRect<LONG>& boundLoop = pTargetLoop->GetIntersectionSpaceRect();
+
+					DxRect<LONG> cellRange = _GetCellRange(boundLoop);
+					for (LONG cy = cellRange.top; cy <= cellRange.bottom; ++cy) {
+						for (LONG cx = cellRange.left; cx <= cellRange.right; ++cx) {
+							size_t iCell = cy * gridWidth_ + cx;
+							for (size_t iEntry = gridCellStart_[iCell]; iEntry < gridCellStart_[iCell + 1]; ++iEntry) {
+								uint32_t iGrid = gridCellTarget_[iEntry];
+								const DxRect<LONG>& boundGrid = pListGrid->at(iGrid)->GetIntersectionSpaceRect();
+
+								//Targets spanning several cells meet in more than one of them,
+								//	only accept the pair in the cell holding the top-left corner of their overlap
+								if (_GetCellX(std::max(boundLoop.left, boundGrid.left)) != cx
+									|| _GetCellY(std::max(boundLoop.top, boundGrid.top)) != cy)
+									continue;
+
+								if (bLoopA)
+									CheckSpaceRect(listCheck, iLoop, iGrid);
+								else
+									CheckSpaceRect(listCheck, iGrid, iLoop);
+							}
+						}
+					}
+				}
+
+				//Cells are visited in grid order, put the pairs back into the order the all-pairs loops below emit them
+				if (bLoopA) {
+					std::sort(listCheck.begin(), listCheck.end(), [](const TargetCheckListPair& a, const TargetCheckListPair& b) {
+						return a.indexA != b.indexA ? a.indexA < b.indexA : a.indexB < b.indexB;
+					});
+				}
+				else {
+					std::sort(listCheck.begin(), listCheck.end(), [](const TargetCheckListPair& a, const TargetCheckListPair& b) {
+						return a.indexB != b.indexB ? a.indexB < b.indexB : a.indexA < b.indexA;
+					});
+				}
+			});
+		}
+		else if (bLoopA) {
+			ParallelForChunk(countLoop, [&](size_t iChunk, size_t begin, size_t end) {
+				std::vector<TargetCheckListPair>& listCheck = listChunkCheckList_[iChunk];
+				listCheck.clear();
+
+				for (size_t iA = begin; iA < end; ++iA) {
+					for (size_t iB = 0; iB < pListTargetB->size(); ++iB)
+						CheckSpaceRect(listCheck, iA, iB);
 				}
 			});
 		}
 		else {
-			ParallelFor(pListTargetB->size(), [&](size_t iB) {
-				StgIntersectionTarget* pTargetB = pListTargetB->at(iB).get();
-				for (auto itrA = pListTargetA->begin(); itrA != pListTargetA->end(); ++itrA) {
-					StgIntersectionTarget* pTargetA = itrA->get();
-					CheckSpaceRect(pTargetA, pTargetB);
+			ParallelForChunk(countLoop, [&](size_t iChunk, size_t begin, size_t end) {
+				std::vector<TargetCheckListPair>& listCheck = listChunkCheckList_[iChunk];
+				listCheck.clear();
+
+				for (size_t iB = begin; iB < end; ++iB) {
+					for (size_t iA = 0; iA < pListTargetA->size(); ++iA)
+						CheckSpaceRect(listCheck, iA, iB);
 				}
 			});
 		}
-		/*
-		//No multithreading mode
-		for (auto itrA = pListTargetA->begin(); itrA != pListTargetA->end(); ++itrA) {
-			StgIntersectionTarget* pTargetA = itrA->get();
-			for (auto itrB = pListTargetB->begin(); itrB != pListTargetB->end(); ++itrB) {
-				StgIntersectionTarget* pTargetB = itrB->get();
-				CheckSpaceRect(pTargetA, pTargetB);
-			}
+
+		//Merge
+		for (size_t iChunk = 0; iChunk < countChunk; ++iChunk)
+			count += listChunkCheckList_[iChunk].size();
+		if (count > pooledCheckList_.size())
+			pooledCheckList_.resize(std::max(count, pooledCheckList_.size() * 2));
+
+		auto itrDst = pooledCheckList_.begin();
+		for (size_t iChunk = 0; iChunk < countChunk; ++iChunk) {
+			std::vector<TargetCheckListPair>& listCheck = listChunkCheckList_[iChunk];
+			itrDst = std::copy(listCheck.begin(), listCheck.end(), itrDst);
 		}
-		*/
 	}
 
-	total = (size_t)count;
+	total = count;
 	previousCheckCreated_ = total;
 	return &pooledCheckList_;
 }
+void StgIntersectionSpace::TestIntersectionCheckList(size_t count, std::vector<uint8_t>& listHit) {
+	if (listHit.size() < count)
+		listHit.resize(count);
+
+	ParallelForChunk(count, [&](size_t iChunk, size_t begin, size_t end) {
+		size_t iCheck = begin;
+
+		//Runs of 4 circle-circle pairs go through the SoA kernel, everything else through IsIntersected
+		for (; iCheck + 4 <= end; iCheck += 4) {
+			const TargetCheckListPair* pPair = &pooledCheckList_[iCheck];
+
+			uint32_t indexA[4];
+			uint32_t indexB[4];
+			bool bAllCircle = true;
+			for (size_t i = 0; i < 4; ++i) {
+				indexA[i] = pPair[i].indexA;
+				indexB[i] = pPair[i].indexB;
+				bAllCircle = bAllCircle && poolCircleA_.IsCircle(indexA[i]) && poolCircleB_.IsCircle(indexB[i]);
+			}
+
+			if (bAllCircle) {
+				int mask = StgIntersectionCirclePool::TestCircle4(poolCircleA_, poolCircleB_, indexA, indexB);
+				for (size_t i = 0; i < 4; ++i)
+					listHit[iCheck + i] = (mask >> i) & 1;
+			}
+			else {
+				for (size_t i = 0; i < 4; ++i)
+					listHit[iCheck + i] = StgIntersectionManager::IsIntersected(pPair[i].first, pPair[i].second);
+			}
+		}
+		for (; iCheck < end; ++iCheck) {
+			const TargetCheckListPair& pair = pooledCheckList_[iCheck];
+			listHit[iCheck] = StgIntersectionManager::IsIntersected(pair.first, pair.second);
+		}
+	});
+}
+
+//*******************************************************************
+//StgIntersectionCirclePool
+//*******************************************************************
+void StgIntersectionCirclePool::Fill(const std::vector<ref_unsync_ptr<StgIntersectionTarget>>& listTarget) {
+	count_ = listTarget.size();
+	if (listX_.size() < count_) {
+		listX_.resize(count_);
+		listY_.resize(count_);
+		listR_.resize(count_);
+		listCircle_.resize(count_);
+	}
+
+	for (size_t i = 0; i < count_; ++i) {
+		const StgIntersectionTarget* pTarget = listTarget[i].get();
+		if (pTarget && pTarget->GetShape() == StgIntersectionTarget::SHAPE_CIRCLE) {
+			const DxCircle& circle = static_cast<const StgIntersectionTarget_Circle*>(pTarget)->GetCircle();
+			listX_[i] = circle.GetX();
+			listY_[i] = circle.GetY();
+			listR_[i] = circle.GetR();
+			listCircle_[i] = 1;
+		}
+		else {
+			listCircle_[i] = 0;
+		}
+	}
+}
+int StgIntersectionCirclePool::TestCircle4(const StgIntersectionCirclePool& poolA, const StgIntersectionCirclePool& poolB,
+	const uint32_t* indexA, const uint32_t* indexB)
+{
+	//Same operations as DxIntersect::Circle_Circle, so results are identical
+#ifdef __L_MATH_VECTORIZE
+	__m128 ax = Vectorize::Set(poolA.listX_[indexA[0]], poolA.listX_[indexA[1]], poolA.listX_[indexA[2]], poolA.listX_[indexA[3]]);
+	__m128 ay = Vectorize::Set(poolA.listY_[indexA[0]], poolA.listY_[indexA[1]], poolA.listY_[indexA[2]], poolA.listY_[indexA[3]]);
+	__m128 ar = Vectorize::Set(poolA.listR_[indexA[0]], poolA.listR_[indexA[1]], poolA.listR_[indexA[2]], poolA.listR_[indexA[3]]);
+	__m128 bx = Vectorize::Set(poolB.listX_[indexB[0]], poolB.listX_[indexB[1]], poolB.listX_[indexB[2]], poolB.listX_[indexB[3]]);
+	__m128 by = Vectorize::Set(poolB.listY_[indexB[0]], poolB.listY_[indexB[1]], poolB.listY_[indexB[2]], poolB.listY_[indexB[3]]);
+	__m128 br = Vectorize::Set(poolB.listR_[indexB[0]], poolB.listR_[indexB[1]], poolB.listR_[indexB[2]], poolB.listR_[indexB[3]]);
+
+	__m128 dx = Vectorize::Sub(ax, bx);
+	__m128 dy = Vectorize::Sub(ay, by);
+	__m128 dd = Vectorize::Add(Vectorize::Mul(dx, dx), Vectorize::Mul(dy, dy));
+	__m128 rr = Vectorize::Add(ar, br);
+	rr = Vectorize::Mul(rr, rr);
+
+	return _mm_movemask_ps(_mm_cmple_ps(dd, rr));
+#else
+	int res = 0;
+	for (size_t i = 0; i < 4; ++i) {
+		float dd = Math::HypotSq(poolA.listX_[indexA[i]] - poolB.listX_[indexB[i]], 
+			poolA.listY_[indexA[i]] - poolB.listY_[indexB[i]]);
+		float rr = poolA.listR_[indexA[i]] + poolB.listR_[indexB[i]];
+		if (dd <= rr * rr)
+			res |= 1 << i;
+	}
+	return res;
+#endif
+}
 
 //*******************************************************************
 //StgIntersectionObject
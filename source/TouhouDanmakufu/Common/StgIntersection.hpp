@@ -66,11 +66,12 @@ public:
 	StgIntersectionTarget_Circle() { shape_ = Shape::SHAPE_CIRCLE; }
 	virtual ~StgIntersectionTarget_Circle() {}
 
-	virtual void SetIntersectionSpace() {
+	virtual void SetIntersectionSpace() final {
 		StgIntersectionTarget::SetIntersectionSpace(circle_.GetBounds());
 	}
 
 	DxCircle& GetCircle() { return circle_; }
+	const DxCircle& GetCircle() const { return circle_; }
 	void SetCircle(const DxCircle& circle) { 
 		circle_ = circle;
 		SetIntersectionSpace();
@@ -84,7 +85,7 @@ public:
 	StgIntersectionTarget_Line() { shape_ = Shape::SHAPE_LINE; }
 	virtual ~StgIntersectionTarget_Line() {}
 
-	virtual void SetIntersectionSpace() {
+	virtual void SetIntersectionSpace() final {
 		StgIntersectionTarget::SetIntersectionSpace(line_.GetBounds());
 	}
 
@@ -101,6 +102,11 @@ class StgIntersectionTargetPoint;
 //StgIntersectionManager
 //*******************************************************************
 class StgIntersectionManager {
+public:
+	typedef enum : uint8_t {
+		BROADPHASE_GRID = 0,		//Uniform grid over the space rect
+		BROADPHASE_ALLPAIRS = 1,	//Test every A against every B, for comparison
+	} Broadphase;
 private:
 	enum {
 		SPACE_PLAYER_ENEMY = 0,
@@ -122,6 +128,9 @@ private:
 	shared_ptr<Shader> shaderVisualizerCircle_;
 	shared_ptr<Shader> shaderVisualizerLine_;
 
+	Broadphase modeBroadphase_;
+	std::vector<uint8_t> listHitCheck_;	//Narrow-phase results, indexed like the space's check list
+
 	CriticalSection lock_;
 public:
 	StgIntersectionManager();
@@ -135,6 +144,9 @@ public:
 	void SetVisualizerRenderPriority(int pri) { visualizerRenderPri_ = pri; }
 	int GetVisualizerRenderPriority() { return visualizerRenderPri_; }
 
+	void SetBroadphaseMode(Broadphase mode) { modeBroadphase_ = mode; }
+	Broadphase GetBroadphaseMode() { return modeBroadphase_; }
+
 	void AddTarget(ref_unsync_ptr<StgIntersectionTarget> target);
 	void AddEnemyTargetToShot(ref_unsync_ptr<StgIntersectionTarget> target);
 	void AddEnemyTargetToPlayer(ref_unsync_ptr<StgIntersectionTarget> target);
@@ -164,6 +176,35 @@ public:
 	ref_unsync_ptr<StgIntersectionTarget> GetTargetB(size_t index);
 };
 
+//*******************************************************************
+//StgIntersectionCirclePool
+//*******************************************************************
+//Struct-of-arrays copy of the circles in a target list, refilled every frame into the same storage
+class StgIntersectionCirclePool {
+	size_t count_;
+	std::vector<float> listX_;
+	std::vector<float> listY_;
+	std::vector<float> listR_;
+	std::vector<uint8_t> listCircle_;	//0 if the target at that index is not a circle
+public:
+	StgIntersectionCirclePool() { count_ = 0; }
+
+	void Fill(const std::vector<ref_unsync_ptr<StgIntersectionTarget>>& listTarget);
+	size_t GetCount() const { return count_; }
+
+	bool IsCircle(uint32_t index) const { return listCircle_[index]; }
+	float GetX(uint32_t index) const { return listX_[index]; }
+	float GetY(uint32_t index) const { return listY_[index]; }
+	float GetR(uint32_t index) const { return listR_[index]; }
+
+	//Circle-circle test of 4 pairs at once, bit N of the result is set if pair N hits
+	static int TestCircle4(const StgIntersectionCirclePool& poolA, const StgIntersectionCirclePool& poolB,
+		const uint32_t* indexA, const uint32_t* indexB);
+};
+
+//*******************************************************************
+//StgIntersectionSpace
+//*******************************************************************
 class StgIntersectionSpace {
 	enum {
 		TYPE_A = 0,
@@ -171,13 +212,46 @@ class StgIntersectionSpace {
 	};
 public:
 	typedef std::vector<ref_unsync_ptr<StgIntersectionTarget>> ListTarget;
-	typedef std::pair<StgIntersectionTarget*, StgIntersectionTarget*> TargetCheckListPair;
+	struct TargetCheckListPair {
+		StgIntersectionTarget* first;
+		StgIntersectionTarget* second;
+		uint32_t indexA;	//Index in the TYPE_A list
+		uint32_t indexB;	//Index in the TYPE_B list
+	};
+
+	static constexpr LONG GRID_CELL_SIZE = 32;
 protected:
 	DxRect<double> spaceRect_;
 
 	size_t previousCheckCreated_;
 	std::pair<ListTarget, ListTarget> pairTargetList_;
 	std::vector<TargetCheckListPair> pooledCheckList_;
+	std::vector<std::vector<TargetCheckListPair>> listChunkCheckList_;	//One per ParallelForChunk chunk
+
+	StgIntersectionCirclePool poolCircleA_;
+	StgIntersectionCirclePool poolCircleB_;
+
+	//Uniform grid broadphase, the smaller of the two target lists is bucketed by cell
+	LONG gridLeft_;
+	LONG gridTop_;
+	LONG gridWidth_;
+	LONG gridHeight_;
+	std::vector<uint32_t> gridCellStart_;		//Offsets into gridCellTarget_, one extra entry at the end
+	std::vector<uint32_t> gridCellFill_;
+	std::vector<uint32_t> gridCellTarget_;		//Indices into the bucketed list
+	std::vector<DxRect<LONG>> gridTargetCell_;	//Cell range covered by each bucketed target
+
+	inline LONG _GetCellX(LONG x) const {
+		return std::clamp<LONG>((x - gridLeft_) / GRID_CELL_SIZE, 0, gridWidth_ - 1);
+	}
+	inline LONG _GetCellY(LONG y) const {
+		return std::clamp<LONG>((y - gridTop_) / GRID_CELL_SIZE, 0, gridHeight_ - 1);
+	}
+	inline DxRect<LONG> _GetCellRange(const DxRect<LONG>& rect) const {
+		return DxRect<LONG>(_GetCellX(rect.left), _GetCellY(rect.top), 
+			_GetCellX(rect.right), _GetCellY(rect.bottom));
+	}
+	void _BuildGrid(ListTarget* pListTarget);
 public:
 	StgIntersectionSpace();
 	virtual ~StgIntersectionSpace();
@@ -190,6 +264,7 @@ public:
 	void ClearTarget();
 
 	std::vector<TargetCheckListPair>* CreateIntersectionCheckList(StgIntersectionManager* manager, size_t& total);
+	void TestIntersectionCheckList(size_t count, std::vector<uint8_t>& listHit);
 };
 
 class StgIntersectionObject {
@@ -66,6 +66,7 @@ public:
 		listObj_.push_back(obj); 
 	}
 	size_t GetItemCount() { return listObj_.size(); }
+	std::list<ref_unsync_ptr<StgItemObject>>& GetItemList() { return listObj_; }
 
 	ID3DXEffect* GetEffect() { return effectItem_; }
 	D3DXMATRIX* GetProjectionMatrix() { return &matProj_; }
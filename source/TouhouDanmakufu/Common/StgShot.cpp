@@ -12,6 +12,8 @@
 StgShotManager::StgShotManager(StgStageController* stageController) {
 	stageController_ = stageController;
 
+	listObj_.reserve(SHOT_MAX);
+
 	listPlayerShotData_ = make_unique<StgShotDataList>();
 	listEnemyShotData_ = make_unique<StgShotDataList>();
 
@@ -20,19 +22,27 @@ StgShotManager::StgShotManager(StgStageController* stageController) {
 	filterMin_ = D3DTEXF_LINEAR;
 	filterMag_ = D3DTEXF_LINEAR;
 
+	bParallelMovement_ = false;
+
 	{
 		RenderShaderLibrary* shaderManager_ = ShaderManager::GetBase()->GetRenderLib();
 		effectShot_ = shaderManager_->GetRender2DShader();
+		effectShotBatch_ = shaderManager_->GetShotBatchShader();
+	}
+	{
+		listBatchInstance_.resize(256);
+		countBatchInstance_ = 0;
+		pBatchTexture_ = nullptr;
+
+		countRenderDraw_ = 0;
+		countRenderBatch_ = 0;
+		countRenderInstance_ = 0;
 	}
 	{
 		size_t renderPriMax = stageController_->GetMainObjectManager()->GetRenderBucketCapacity();
 
 		listRenderQueuePlayer_.resize(renderPriMax);
 		listRenderQueueEnemy_.resize(renderPriMax);
-		for (size_t i = 0; i < renderPriMax; ++i) {
-			listRenderQueuePlayer_[i].listShot.resize(32);
-			listRenderQueueEnemy_[i].listShot.resize(32);
-		}
 	}
 	pLastTexture_ = nullptr;
 
@@ -45,18 +55,79 @@ StgShotManager::~StgShotManager() {
 		if (obj)
 			obj->ClearShotObject();
 	}
+	listObj_.clear();
+
+	for (SlabAllocator* pAllocator : listAllocator_)
+		pAllocator->Release();
+}
+SlabAllocator* StgShotManager::_GetAllocator(size_t sizeBlock) {
+	//Only a handful of shot classes exist, so a linear search by block size is enough
+	sizeBlock = SlabAllocator::GetAlignedSize(sizeBlock);
+	for (SlabAllocator* pAllocator : listAllocator_) {
+		if (pAllocator->GetBlockSize() == sizeBlock)
+			return pAllocator;
+	}
+	listAllocator_.push_back(new SlabAllocator(sizeBlock, 256));
+	return listAllocator_.back();
 }
 void StgShotManager::Work() {
-	for (auto itr = listObj_.begin(); itr != listObj_.end(); ) {
+	//Compact in place, keeping the order of the remaining shots
+	auto itrDst = listObj_.begin();
+	for (auto itr = listObj_.begin(); itr != listObj_.end(); ++itr) {
 		ref_unsync_ptr<StgShotObject>& obj = *itr;
 		if (obj->IsDeleted()) {
 			obj->ClearShotObject();
-			itr = listObj_.erase(itr);
+			continue;
 		}
 		else if (!obj->IsActive()) {
-			itr = listObj_.erase(itr);
+			continue;
 		}
-		else ++itr;
+
+		if (itrDst != itr)
+			*itrDst = obj;
+		++itrDst;
+	}
+	listObj_.erase(itrDst, listObj_.end());
+}
+void StgShotManager::WorkMovementParallel() {
+	if (!bParallelMovement_) return;
+
+	//Patterns attached this frame read the positions of their relative objects when they activate.
+	//	Shots read that way must move serially in object order, or the reader may see them already moved.
+	listPatternRelative_.clear();
+	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
+		if (!obj->IsDeleted() && obj->IsActive())
+			obj->GetPendingPatternRelativeObjects(&listPatternRelative_);
+	}
+	for (ref_unsync_ptr<StgEnemyObject>& obj : stageController_->GetEnemyManager()->GetEnemyList()) {
+		if (!obj->IsDeleted() && obj->IsActive())
+			obj->GetPendingPatternRelativeObjects(&listPatternRelative_);
+	}
+	for (ref_unsync_ptr<StgItemObject>& obj : stageController_->GetItemManager()->GetItemList()) {
+		if (!obj->IsDeleted() && obj->IsActive())
+			obj->GetPendingPatternRelativeObjects(&listPatternRelative_);
+	}
+	std::sort(listPatternRelative_.begin(), listPatternRelative_.end());
+
+	listParallelMovement_.clear();
+	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
+		if (obj->IsDeleted() || !obj->IsActive()) continue;
+		if (!obj->IsParallelMovementAllowed()) continue;
+		if (std::binary_search(listPatternRelative_.begin(), listPatternRelative_.end(), (StgMoveObject*)obj.get())) continue;
+		listParallelMovement_.push_back(obj.get());
+	}
+
+	//Shots only move themselves here, nothing outside the object is touched
+	ParallelFor(listParallelMovement_.size(), [&](size_t i) {
+		listParallelMovement_[i]->PrepareMovement();
+	});
+
+	//The rest of their Work() runs serially in the order the shots were registered, before any other object
+	//	is updated. Deletion and delete events therefore happen in a fixed order with every moved shot
+	//	already at its new position, and the object pass then skips these shots.
+	for (StgShotObject* obj : listParallelMovement_) {
+		if (obj->IsDeleted()) continue;
+		obj->WorkAhead();
 	}
 }
 
@@ -70,6 +141,15 @@ std::array<BlendMode, StgShotManager::BLEND_COUNT> StgShotManager::blendTypeRend
 	MODE_BLEND_ALPHA,
 	MODE_BLEND_ALPHA_INV,
 };
+//Unit quad, expanded by the instance data in the batch shader
+std::array<VERTEX_TLX, 4> StgShotManager::vertexBatchQuad_ = {
+	VERTEX_TLX(D3DXVECTOR4(0, 0, 0, 1), 0xffffffff, D3DXVECTOR2(0, 0)),
+	VERTEX_TLX(D3DXVECTOR4(1, 0, 0, 1), 0xffffffff, D3DXVECTOR2(1, 0)),
+	VERTEX_TLX(D3DXVECTOR4(0, 1, 0, 1), 0xffffffff, D3DXVECTOR2(0, 1)),
+	VERTEX_TLX(D3DXVECTOR4(1, 1, 0, 1), 0xffffffff, D3DXVECTOR2(1, 1)),
+};
+std::array<uint16_t, 4> StgShotManager::indexBatchQuad_ = { 0, 1, 2, 3 };
+
 void StgShotManager::Render(int targetPriority) {
 	if (targetPriority < 0 || targetPriority >= listRenderQueueEnemy_.size()) return;
 
@@ -101,23 +181,33 @@ void StgShotManager::Render(int targetPriority) {
 	device->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
 	pLastTexture_ = nullptr;
 
+	countBatchInstance_ = 0;
+	pBatchTexture_ = nullptr;
+
 	if (D3DXHANDLE handle = effectShot_->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
 		effectShot_->SetMatrix(handle, &matProj_);
 	}
+	if (D3DXHANDLE handle = effectShotBatch_->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
+		effectShotBatch_->SetMatrix(handle, &matProj_);
+	}
 
 	auto _RenderQueue = [&](const RenderQueue& renderQueue) {
 		if (renderQueue.count == 0) return;
 
 		for (size_t iBlend = 0; iBlend < blendTypeRenderOrder.size(); ++iBlend) {
+			const std::vector<StgShotObject*>& listShot = renderQueue.listShot[iBlend];
+			if (listShot.empty()) continue;
+
 			BlendMode blend = blendTypeRenderOrder[iBlend];
 
 			graphics->SetBlendMode(blend);
 			effectShot_->SetTechnique(blend == MODE_BLEND_ALPHA_INV ? "RenderInv" : "Render");
+			effectShotBatch_->SetTechnique(blend == MODE_BLEND_ALPHA_INV ? "RenderInv" : "Render");
 
-			for (size_t i = 0; i < renderQueue.count; ++i) {
-				StgShotObject* pShot = renderQueue.listShot[i];
+			for (StgShotObject* pShot : listShot)
 				pShot->Render(blend);
-			}
+
+			FlushBatch();
 		}
 	};
 
@@ -133,21 +223,142 @@ void StgShotManager::Render(int targetPriority) {
 	if (bEnableFog)
 		graphics->SetFogEnable(true);
 }
+void StgShotManager::AddBatchInstance(IDirect3DTexture9* pTexture, StgShotDataFrame* shotFrame, 
+	const D3DXMATRIX& matWorld, D3DCOLOR color) 
+{
+	if (pTexture != pBatchTexture_) {
+		FlushBatch();
+		pBatchTexture_ = pTexture;
+	}
+
+	if (countBatchInstance_ >= listBatchInstance_.size())
+		listBatchInstance_.resize(listBatchInstance_.size() * 2);
+
+	const DxRect<float>& rcDst = shotFrame->rcDst_;
+	const DxRect<float>& rcTex = shotFrame->rcTexCoord_;
+
+	float width = rcDst.right - rcDst.left;
+	float height = rcDst.bottom - rcDst.top;
+
+	//The transformed quad as its top-left corner and two edges
+	VERTEX_INSTANCE* pInstance = &listBatchInstance_[countBatchInstance_++];
+	pInstance->diffuse_color = color;
+	pInstance->xyz_pos_x_scale = D3DXVECTOR4(
+		rcDst.left * matWorld._11 + rcDst.top * matWorld._21 + matWorld._41,
+		rcDst.left * matWorld._12 + rcDst.top * matWorld._22 + matWorld._42,
+		width * matWorld._11, width * matWorld._12);
+	pInstance->yz_scale_xy_ang = D3DXVECTOR4(
+		height * matWorld._21, height * matWorld._22,
+		rcTex.left, rcTex.top);
+	pInstance->z_ang_extra = D3DXVECTOR4(rcTex.right, rcTex.bottom, 0, 0);
+}
+void StgShotManager::FlushBatch() {
+	//Shots are only batched with hardware instancing, see StgShotObject::_DefaultShotRender
+#ifdef __L_USE_HWINSTANCING
+	if (countBatchInstance_ == 0) return;
+
+	DirectGraphics* graphics = DirectGraphics::GetBase();
+	IDirect3DDevice9* device = graphics->GetDevice();
+	VertexBufferManager* bufferManager = VertexBufferManager::GetBase();
+	RenderShaderLibrary* shaderManager = ShaderManager::GetBase()->GetRenderLib();
+
+	size_t countInstance = countBatchInstance_;
+	countBatchInstance_ = 0;
+
+	if (graphics->IsAllowRenderTargetChange())
+		graphics->SetRenderTarget(nullptr);
+
+	if (pBatchTexture_ != pLastTexture_) {
+		device->SetTexture(0, pBatchTexture_);
+		pLastTexture_ = pBatchTexture_;
+	}
+
+	FixedVertexBuffer* vertexBuffer = bufferManager->GetVertexBufferTLX();
+	GrowableVertexBuffer* instanceBuffer = bufferManager->GetInstancingVertexBuffer();
+	FixedIndexBuffer* indexBuffer = bufferManager->GetIndexBuffer();
+
+	instanceBuffer->Expand(countInstance);
+
+	{
+		BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
+
+		lockParam.SetSource(vertexBatchQuad_, vertexBatchQuad_.size(), sizeof(VERTEX_TLX));
+		vertexBuffer->UpdateBuffer(&lockParam);
+
+		lockParam.SetSource(listBatchInstance_, countInstance, sizeof(VERTEX_INSTANCE));
+		instanceBuffer->UpdateBuffer(&lockParam);
+
+		lockParam.SetSource(indexBatchQuad_, indexBatchQuad_.size(), sizeof(uint16_t));
+		indexBuffer->UpdateBuffer(&lockParam);
+	}
+
+	device->SetVertexDeclaration(shaderManager->GetVertexDeclarationInstancedTLX());
+
+	device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
+	device->SetStreamSourceFreq(0, D3DSTREAMSOURCE_INDEXEDDATA | countInstance);
+	device->SetStreamSource(1, instanceBuffer->GetBuffer(), 0, sizeof(VERTEX_INSTANCE));
+	device->SetStreamSourceFreq(1, D3DSTREAMSOURCE_INSTANCEDATA | 1U);
+
+	device->SetIndices(indexBuffer->GetBuffer());
+
+	{
+		UINT countPass = 1;
+		effectShotBatch_->Begin(&countPass, D3DXFX_DONOTSAVESHADERSTATE);
+		for (UINT iPass = 0; iPass < countPass; ++iPass) {
+			effectShotBatch_->BeginPass(iPass);
+			device->DrawIndexedPrimitive(D3DPT_TRIANGLESTRIP, 0, 0, 4, 0, 2);
+			effectShotBatch_->EndPass();
+		}
+		effectShotBatch_->End();
+	}
+
+	device->SetStreamSourceFreq(0, 1);
+	device->SetStreamSourceFreq(1, 1);
+
+	//Back to the state the unbatched shot paths expect
+	device->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
+	device->SetIndices(nullptr);
+
+	++countRenderDraw_;
+	++countRenderBatch_;
+	countRenderInstance_ += countInstance;
+#endif
+}
 void StgShotManager::LoadRenderQueue() {
+	countRenderDraw_ = 0;
+	countRenderBatch_ = 0;
+	countRenderInstance_ = 0;
+
 	for (size_t i = 0; i < listRenderQueuePlayer_.size(); ++i) {
-		listRenderQueuePlayer_[i].count = 0;
-		listRenderQueueEnemy_[i].count = 0;
+		for (RenderQueue* pQueue : { &listRenderQueuePlayer_[i], &listRenderQueueEnemy_[i] }) {
+			pQueue->count = 0;
+			for (auto& listShot : pQueue->listShot)
+				listShot.clear();
+		}
 	}
 
+	//Blend mode -> index in blendTypeRenderOrder
+	std::array<int8_t, 16> indexBlendOrder;
+	indexBlendOrder.fill(-1);
+	for (size_t iBlend = 0; iBlend < blendTypeRenderOrder.size(); ++iBlend)
+		indexBlendOrder[blendTypeRenderOrder[iBlend]] = iBlend;
+
 	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
 		if (obj->IsDeleted() || !obj->IsActive() || !obj->IsVisible()) continue;
 
-		auto& [count, listShot] = (obj->GetOwnerType() == StgShotObject::OWNER_PLAYER ?
+		uint16_t maskBlend = obj->GetRenderBlendMask();
+		if (maskBlend == 0) continue;
+
+		RenderQueue& renderQueue = (obj->GetOwnerType() == StgShotObject::OWNER_PLAYER ?
 			listRenderQueuePlayer_ : listRenderQueueEnemy_)[obj->GetRenderPriorityI()];
 
-		while (count >= listShot.size())
-			listShot.resize(listShot.size() * 2);
-		listShot[count++] = obj.get();
+		//A shot is queued once in each blend it draws in, shots with the delay and main graphic
+		//	in the same blend are still drawn by a single Render call
+		for (size_t iMode = 0; maskBlend != 0; ++iMode, maskBlend >>= 1) {
+			if ((maskBlend & 1) == 0 || indexBlendOrder[iMode] < 0) continue;
+			renderQueue.listShot[indexBlendOrder[iMode]].push_back(obj.get());
+			++renderQueue.count;
+		}
 	}
 }
 
@@ -170,7 +381,9 @@ void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, i
 
 	DxRect<int> rcBox(cx - r, cy - r, cx + r, cy + r);
 
-	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
+	//Indexed, delete events may spawn new shots into listObj_
+	for (size_t iObj = 0; iObj < listObj_.size(); ++iObj) {
+		ref_unsync_ptr<StgShotObject> obj = listObj_[iObj];
 		if (obj->IsDeleted()) continue;
 		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
 		if (typeDelete == DEL_TYPE_SHOT && obj->IsSpellResist()) continue;
@@ -302,6 +515,9 @@ void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>
 				LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
 				float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
 
+				pFrame->rcTexCoord_ = DxRect<float>(ptrSrc[0] / texW, ptrSrc[1] / texH,
+					ptrSrc[2] / texW, ptrSrc[3] / texH);
+
 				for (size_t iVert = 0; iVert < 4; ++iVert) {
 					VERTEX_TLX* pv = &verts[iVert];
 
@@ -766,6 +982,12 @@ StgShotObject::StgShotObject(StgStageController* stageController) : StgMoveObjec
 
 	typeOwner_ = OWNER_ENEMY;
 
+	bMovementPrepared_ = false;
+	clipPrepared_ = -1;
+	posClipPrepared_[0] = 0;
+	posClipPrepared_[1] = 0;
+	bWorkedAhead_ = false;
+
 	bUserIntersectionMode_ = false;
 	bIntersectionEnable_ = true;
 	bChangeItemEnable_ = true;
@@ -881,16 +1103,23 @@ void StgShotObject::_RequestPlayerDeleteEvent(int hitObjectID) {	//A super ugly
 	}
 }
 
-void StgShotObject::_DeleteInAutoClip() {
-	if (IsDeleted() || !IsAutoDelete()) return;
-
+bool StgShotObject::_IsOutsideDeleteClip() {
 	DxRect<LONG>* const rcStgFrame = stageController_->GetStageInformation()->GetStgFrameRect();
 	DxRect<LONG>* const rcClipBase = stageController_->GetShotManager()->GetShotDeleteClip();
 	DxRect<LONG> rcDeleteClip(rcClipBase->left, rcClipBase->top,
 		rcStgFrame->GetWidth() + rcClipBase->right,
 		rcStgFrame->GetHeight() + rcClipBase->bottom);
 
-	if (!rcDeleteClip.IsPointIntersected(posX_, posY_)) {
+	return !rcDeleteClip.IsPointIntersected(posX_, posY_);
+}
+void StgShotObject::_DeleteInAutoClip() {
+	if (IsDeleted() || !IsAutoDelete()) return;
+
+	//Reuse the test from PrepareMovement unless something moved the shot since
+	bool bOutside = (clipPrepared_ >= 0 && posClipPrepared_[0] == posX_ && posClipPrepared_[1] == posY_) ?
+		(clipPrepared_ == 1) : _IsOutsideDeleteClip();
+
+	if (bOutside) {
 		auto objectManager = stageController_->GetMainObjectManager();
 		objectManager->DeleteObject(this);
 	}
@@ -1422,34 +1651,57 @@ void StgNormalShotObject::Clone(DxScriptObjectBase* _src) {
 }
 
 void StgNormalShotObject::Work() {
-	if (bEnableMovement_) {
-		_ProcessTransformAct();
-		_Move();
+	if (bWorkedAhead_) {
+		bWorkedAhead_ = false;
+		return;
+	}
 
-		if (delay_.time > 0) {
-			--(delay_.time);
-			delay_.angle.x += delay_.angle.y;
-		}
+	if (bEnableMovement_ && !bMovementPrepared_)
+		_WorkMovement();
 
-		{
-			angle_.z += angularVelocity_;
+	_CommonWorkTask();
 
-			bool bDelay = delay_.time > 0 && delay_.angle.y != 0;
+	bMovementPrepared_ = false;
+	clipPrepared_ = -1;
+}
+bool StgNormalShotObject::IsParallelMovementAllowed() {
+	//Transform acts and pattern attachment can read other objects or create new ones
+	return bEnableMovement_ && !bMovementPrepared_
+		&& listTransformationShotAct_.empty() && !_IsPatternAttachPending();
+}
+void StgNormalShotObject::PrepareMovement() {
+	_WorkMovement();
+	bMovementPrepared_ = true;
 
-			double angleZ = bDelay ? delay_.angle.x : angle_.z;
-			if (StgShotData* shotData = _GetShotData()) {
-				if (!bFixedAngle_ && !bDelay) angleZ += GetDirectionAngle() + Math::DegreeToRadian(90);
-			}
+	posClipPrepared_[0] = posX_;
+	posClipPrepared_[1] = posY_;
+	clipPrepared_ = _IsOutsideDeleteClip() ? 1 : 0;
+}
+void StgNormalShotObject::_WorkMovement() {
+	_ProcessTransformAct();
+	_Move();
 
-			if (angleZ != lastAngle_) {
-				double ang = (roundingAngle_ > 0) ? round(angleZ / roundingAngle_) * roundingAngle_ : angleZ;
-				move_ = D3DXVECTOR2(cosf(ang), sinf(ang));
-				lastAngle_ = angleZ;
-			}
-		}
+	if (delay_.time > 0) {
+		--(delay_.time);
+		delay_.angle.x += delay_.angle.y;
 	}
 
-	_CommonWorkTask();
+	{
+		angle_.z += angularVelocity_;
+
+		bool bDelay = delay_.time > 0 && delay_.angle.y != 0;
+
+		double angleZ = bDelay ? delay_.angle.x : angle_.z;
+		if (StgShotData* shotData = _GetShotData()) {
+			if (!bFixedAngle_ && !bDelay) angleZ += GetDirectionAngle() + Math::DegreeToRadian(90);
+		}
+
+		if (angleZ != lastAngle_) {
+			double ang = (roundingAngle_ > 0) ? round(angleZ / roundingAngle_) * roundingAngle_ : angleZ;
+			move_ = D3DXVECTOR2(cosf(ang), sinf(ang));
+			lastAngle_ = angleZ;
+		}
+	}
 }
 
 void StgNormalShotObject::_AddIntersectionRelativeTarget() {
@@ -1534,6 +1786,15 @@ bool StgNormalShotObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 	return true;
 }
 
+uint16_t StgShotObject::GetRenderBlendMask() {
+	uint16_t res = 0;
+	for (int iPart = 0; iPart < PART_COUNT; ++iPart) {
+		BlendMode blend = _GetRenderPartBlend((RenderPart)iPart);
+		if (blend != MODE_BLEND_NONE)
+			res |= _GetBlendBit(blend);
+	}
+	return res;
+}
 void StgShotObject::_DefaultShotRender(StgShotData* shotData, StgShotDataFrame* shotFrame, const D3DXMATRIX& matWorld, D3DCOLOR color) {
 	if (shotFrame == nullptr) return;
 	StgShotManager* shotManager = stageController_->GetShotManager();
@@ -1545,6 +1806,15 @@ void StgShotObject::_DefaultShotRender(StgShotData* shotData, StgShotDataFrame*
 		DirectGraphics* graphics = DirectGraphics::GetBase();
 		IDirect3DDevice9* device = graphics->GetDevice();
 
+#ifdef __L_USE_HWINSTANCING
+		//Default-shaded shots go into the manager's instanced batch
+		if (shader_ == nullptr && renderTarget_.expired()) {
+			shotManager->AddBatchInstance(pVB->GetD3DTexture(), shotFrame, matWorld, color);
+			return;
+		}
+		shotManager->FlushBatch();
+#endif
+
 		if (graphics->IsAllowRenderTargetChange()) {
 			if (auto pRT = renderTarget_.lock())
 				graphics->SetRenderTarget(pRT);
@@ -1591,11 +1861,23 @@ void StgShotObject::_DefaultShotRender(StgShotData* shotData, StgShotDataFrame*
 					effect->EndPass();
 				}
 				effect->End();
+
+				shotManager->AddRenderDrawCount();
 			}
 		}
 	}
 }
 
+BlendMode StgNormalShotObject::_GetRenderPartBlend(RenderPart part) {
+	StgShotData* shotData = _GetShotData();
+	if (shotData == nullptr) return MODE_BLEND_NONE;
+
+	if (part == PART_DELAY && delay_.time > 0)
+		return _GetBlendOrDefault(GetDelayBlendType(), shotData->GetDelayRenderType());
+	if (part == PART_MAIN && delay_.time == 0)
+		return _GetBlendOrDefault(GetBlendType(), shotData->GetRenderType());
+	return MODE_BLEND_NONE;
+}
 void StgNormalShotObject::Render(BlendMode targetBlend) {
 	//if (!IsVisible()) return;
 	StgShotManager* shotManager = stageController_->GetShotManager();
@@ -1626,11 +1908,7 @@ void StgNormalShotObject::Render(BlendMode targetBlend) {
 		_DefaultShotRender(pData, pFrame, matTransform, color);
 	};
 
-	if (delay_.time > 0) {
-		BlendMode objBlendType = GetDelayBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? shotData->GetDelayRenderType() : objBlendType;
-		if (objBlendType != targetBlend) return;
-
+	if (_GetRenderPartBlend(PART_DELAY) == targetBlend) {
 		StgShotData* delayData = _GetShotData(delay_.id >= 0 ? delay_.id : shotData->GetDefaultDelayID());
 		if (delayData) {
 			StgShotDataFrame* delayFrame = delayData ? delayData->GetFrame(frameWork_) : nullptr;
@@ -1651,11 +1929,7 @@ void StgNormalShotObject::Render(BlendMode targetBlend) {
 			_Render(delayData, delayFrame);
 		}
 	}
-	else {
-		BlendMode objBlendType = GetBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? shotData->GetRenderType() : objBlendType;
-		if (objBlendType != targetBlend) return;
-
+	else if (_GetRenderPartBlend(PART_MAIN) == targetBlend) {
 		scaleX = scale_.x;
 		scaleY = scale_.y;
 		color = color_;
@@ -1932,6 +2206,15 @@ bool StgLooseLaserObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 	return true;
 }
 
+BlendMode StgLooseLaserObject::_GetRenderPartBlend(RenderPart part) {
+	if (_GetShotData() == nullptr) return MODE_BLEND_NONE;
+
+	if (part == PART_DELAY && delay_.time > 0)
+		return _GetBlendOrDefault(GetDelayBlendType(), MODE_BLEND_ADD_ARGB);
+	if (part == PART_MAIN && (delay_.time == 0 || bEnableMotionDelay_))
+		return _GetBlendOrDefault(GetBlendType(), MODE_BLEND_ADD_ARGB);
+	return MODE_BLEND_NONE;
+}
 void StgLooseLaserObject::Render(BlendMode targetBlend) {
 	//if (!IsVisible()) return;
 	StgShotManager* shotManager = stageController_->GetShotManager();
@@ -1945,9 +2228,8 @@ void StgLooseLaserObject::Render(BlendMode targetBlend) {
 	D3DCOLOR rColor;
 
 	//Render delay
-	if (delay_.time > 0) {
-		BlendMode objBlendType = GetDelayBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+	{
+		BlendMode objBlendType = _GetRenderPartBlend(PART_DELAY);
 
 		if (objBlendType == targetBlend) {
 			StgShotData* delayData = _GetShotData(delay_.id >= 0 ? delay_.id : shotData->GetDefaultDelayID());
@@ -1981,9 +2263,8 @@ void StgLooseLaserObject::Render(BlendMode targetBlend) {
 	}
 
 	//Render laser
-	if (delay_.time == 0 || bEnableMotionDelay_) {
-		BlendMode objBlendType = GetBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+	{
+		BlendMode objBlendType = _GetRenderPartBlend(PART_MAIN);
 
 		if (objBlendType == targetBlend) {
 			StgShotDataFrame* shotFrame = shotData->GetFrame(frameWork_);
@@ -2201,6 +2482,15 @@ bool StgStraightLaserObject::GetIntersectionTargetList_NoVector(StgShotData* sho
 	return true;
 }
 
+BlendMode StgStraightLaserObject::_GetRenderPartBlend(RenderPart part) {
+	if (_GetShotData() == nullptr) return MODE_BLEND_NONE;
+
+	if (part == PART_MAIN)
+		return _GetBlendOrDefault(GetBlendType(), MODE_BLEND_ADD_ARGB);
+	if (part == PART_DELAY && (bUseSouce_ || bUseEnd_) && (frameFadeDelete_ < 0))
+		return _GetBlendOrDefault(GetDelayBlendType(), MODE_BLEND_ADD_ARGB);
+	return MODE_BLEND_NONE;
+}
 void StgStraightLaserObject::Render(BlendMode targetBlend) {
 	//if (!IsVisible()) return;
 	StgShotManager* shotManager = stageController_->GetShotManager();
@@ -2212,8 +2502,7 @@ void StgStraightLaserObject::Render(BlendMode targetBlend) {
 
 	//Render laser
 	{
-		BlendMode objBlendType = GetBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+		BlendMode objBlendType = _GetRenderPartBlend(PART_MAIN);
 
 		if (objBlendType == targetBlend) {
 			StgShotDataFrame* shotFrame = shotData->GetFrame(frameWork_);
@@ -2253,9 +2542,8 @@ void StgStraightLaserObject::Render(BlendMode targetBlend) {
 	}
 
 	//Render delay(s)
-	if ((bUseSouce_ || bUseEnd_) && (frameFadeDelete_ < 0)) {
-		BlendMode objBlendType = GetDelayBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+	{
+		BlendMode objBlendType = _GetRenderPartBlend(PART_DELAY);
 
 		if (objBlendType == targetBlend) {
 			rColor = (delay_.colorRep != 0) ? delay_.colorRep : shotData->GetDelayColor();
@@ -2535,6 +2823,15 @@ bool StgCurveLaserObject::GetIntersectionTargetList_NoVector(StgShotData* shotDa
 	return true;
 }
 
+BlendMode StgCurveLaserObject::_GetRenderPartBlend(RenderPart part) {
+	if (_GetShotData() == nullptr) return MODE_BLEND_NONE;
+
+	if (part == PART_DELAY && delay_.time > 0)
+		return _GetBlendOrDefault(GetDelayBlendType(), MODE_BLEND_ADD_ARGB);
+	if (part == PART_MAIN && listPosition_.size() > 1U)
+		return _GetBlendOrDefault(GetBlendType(), MODE_BLEND_ADD_ARGB);
+	return MODE_BLEND_NONE;
+}
 void StgCurveLaserObject::Render(BlendMode targetBlend) {
 	//if (!IsVisible()) return;
 	StgShotManager* shotManager = stageController_->GetShotManager();
@@ -2543,9 +2840,8 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 	if (shotData == nullptr) return;
 
 	//Render delay
-	if (delay_.time > 0) {
-		BlendMode objBlendType = GetDelayBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+	{
+		BlendMode objBlendType = _GetRenderPartBlend(PART_DELAY);
 
 		if (objBlendType == targetBlend) {
 			StgShotData* delayData = _GetShotData(delay_.id >= 0 ? delay_.id : shotData->GetDefaultDelayID());
@@ -2583,9 +2879,8 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 	}
 
 	//Render laser
-	if (listPosition_.size() > 1U) {
-		BlendMode objBlendType = GetBlendType();
-		objBlendType = objBlendType == MODE_BLEND_NONE ? MODE_BLEND_ADD_ARGB : objBlendType;
+	{
+		BlendMode objBlendType = _GetRenderPartBlend(PART_MAIN);
 
 		if (objBlendType == targetBlend) {
 			StgShotDataFrame* shotFrame = shotData->GetFrame(frameWork_);
@@ -2708,6 +3003,8 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 				VertexBufferManager* vbManager = VertexBufferManager::GetBase();
 				FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferTLX();
 
+				shotManager->FlushBatch();
+
 				if (graphics->IsAllowRenderTargetChange()) {
 					if (auto pRT = renderTarget_.lock())
 						graphics->SetRenderTarget(pRT);
@@ -2765,6 +3062,8 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 							effect->EndPass();
 						}
 						effect->End();
+
+						shotManager->AddRenderDrawCount();
 					}
 				}
 			}
@@ -2949,13 +3248,13 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 		switch (typeShot_) {
 		case TypeObject::Shot:
 		{
-			ref_unsync_ptr<StgNormalShotObject> ptrShot(new StgNormalShotObject(controller));
+			ref_unsync_ptr<StgNormalShotObject> ptrShot = shotManager->CreateShotObject<StgNormalShotObject>();
 			objShot = ptrShot;
 			break;
 		}
 		case TypeObject::LooseLaser:
 		{
-			ref_unsync_ptr<StgLooseLaserObject> ptrShot(new StgLooseLaserObject(controller));
+			ref_unsync_ptr<StgLooseLaserObject> ptrShot = shotManager->CreateShotObject<StgLooseLaserObject>();
 			ptrShot->SetLength(laserLength_);
 			ptrShot->SetRenderWidth(laserWidth_);
 			objShot = ptrShot;
@@ -2963,7 +3262,7 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 		}
 		case TypeObject::StraightLaser:
 		{
-			ref_unsync_ptr<StgStraightLaserObject> ptrShot(new StgStraightLaserObject(controller));
+			ref_unsync_ptr<StgStraightLaserObject> ptrShot = shotManager->CreateShotObject<StgStraightLaserObject>();
 			ptrShot->SetLength(laserLength_);
 			ptrShot->SetRenderWidth(laserWidth_);
 			objShot = ptrShot;
@@ -2971,7 +3270,7 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 		}
 		case TypeObject::CurveLaser:
 		{
-			ref_unsync_ptr<StgCurveLaserObject> ptrShot(new StgCurveLaserObject(controller));
+			ref_unsync_ptr<StgCurveLaserObject> ptrShot = shotManager->CreateShotObject<StgCurveLaserObject>();
 			ptrShot->SetLength(laserLength_);
 			ptrShot->SetRenderWidth(laserWidth_);
 			objShot = ptrShot;
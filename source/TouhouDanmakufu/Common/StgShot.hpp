@@ -7,6 +7,7 @@
 
 class StgShotDataList;
 class StgShotData;
+struct StgShotDataFrame;
 class StgShotVertexBufferContainer;
 class StgShotObject;
 //*******************************************************************
@@ -43,7 +44,7 @@ protected:
 	static std::array<BlendMode, BLEND_COUNT> blendTypeRenderOrder;
 	struct RenderQueue {
 		size_t count;
-		std::vector<StgShotObject*> listShot;
+		std::array<std::vector<StgShotObject*>, BLEND_COUNT> listShot;	//one for each blend, in render order
 	};
 protected:
 	StgStageController* stageController_;
@@ -51,12 +52,19 @@ protected:
 	unique_ptr<StgShotDataList> listPlayerShotData_;
 	unique_ptr<StgShotDataList> listEnemyShotData_;
 
-	std::list<ref_unsync_ptr<StgShotObject>> listObj_;
+	std::vector<ref_unsync_ptr<StgShotObject>> listObj_;
+	//Shots and their reference counters share blocks from these, one allocator per block size
+	//	Released by the destructor, each one lives until the last weak reference into it is gone
+	std::vector<SlabAllocator*> listAllocator_;
 	std::vector<RenderQueue> listRenderQueuePlayer_;		//one for each render pri
 	std::vector<RenderQueue> listRenderQueueEnemy_;			//one for each render pri
 
 	std::bitset<(int)TypeDelete::_Max> listDeleteEventEnable_;
 
+	bool bParallelMovement_;
+	std::vector<StgShotObject*> listParallelMovement_;
+	std::vector<StgMoveObject*> listPatternRelative_;	//Sorted
+
 	DxRect<LONG> rcDeleteClip_;
 
 	D3DTEXTUREFILTERTYPE filterMin_;
@@ -64,6 +72,21 @@ protected:
 
 	ID3DXEffect* effectShot_;
 	D3DXMATRIX matProj_;
+
+	//Instanced batching of consecutive shots that share a texture and use the default shader,
+	//	only used with __L_USE_HWINSTANCING
+	static std::array<VERTEX_TLX, 4> vertexBatchQuad_;
+	static std::array<uint16_t, 4> indexBatchQuad_;
+	ID3DXEffect* effectShotBatch_;
+	std::vector<VERTEX_INSTANCE> listBatchInstance_;
+	size_t countBatchInstance_;
+	IDirect3DTexture9* pBatchTexture_;
+
+	size_t countRenderDraw_;
+	size_t countRenderBatch_;
+	size_t countRenderInstance_;
+
+	SlabAllocator* _GetAllocator(size_t sizeBlock);
 public:
 	IDirect3DTexture9* pLastTexture_;
 public:
@@ -71,16 +94,28 @@ public:
 	virtual ~StgShotManager();
 
 	void Work();
+	void WorkMovementParallel();
 	void Render(int targetPriority);
 	void LoadRenderQueue();
 
 	void RegistIntersectionTarget();
 
 	void AddShot(ref_unsync_ptr<StgShotObject> obj);
+	template<class T> ref_unsync_ptr<T> CreateShotObject() {
+		return ref_unsync_ptr<T>::CreateInPool(_GetAllocator(ref_unsync_ptr<T>::GetPoolBlockSize()), stageController_);
+	}
 
 	ID3DXEffect* GetEffect() { return effectShot_; }
 	D3DXMATRIX* GetProjectionMatrix() { return &matProj_; }
 
+	void AddBatchInstance(IDirect3DTexture9* pTexture, StgShotDataFrame* shotFrame, const D3DXMATRIX& matWorld, D3DCOLOR color);
+	void FlushBatch();
+	void AddRenderDrawCount() { ++countRenderDraw_; }
+
+	size_t GetRenderDrawCount() { return countRenderDraw_; }
+	size_t GetRenderBatchCount() { return countRenderBatch_; }
+	size_t GetRenderInstanceCount() { return countRenderInstance_; }
+
 	StgShotDataList* GetPlayerShotDataList() { return listPlayerShotData_.get(); }
 	StgShotDataList* GetEnemyShotDataList() { return listEnemyShotData_.get(); }
 
@@ -99,9 +134,14 @@ public:
 	std::vector<int> GetShotIdInCircle(int typeOwner, int cx, int cy, optional<int> radius);
 	size_t GetShotCount(int typeOwner);
 	size_t GetShotCountAll() { return listObj_.size(); }
+	std::vector<ref_unsync_ptr<StgShotObject>>& GetShotList() { return listObj_; }
 
 	void SetDeleteEventEnableByType(int type, bool bEnable);
 	bool IsDeleteEventEnable(TypeDelete bit) { return listDeleteEventEnable_[(int)bit]; }
+
+	//Moved shots finish their whole update before any other object, see WorkMovementParallel
+	void SetParallelMovementEnable(bool bEnable) { bParallelMovement_ = bEnable; }
+	bool IsParallelMovementEnable() { return bParallelMovement_; }
 };
 
 //*******************************************************************
@@ -142,6 +182,7 @@ struct StgShotDataFrame {
 
 	DxRect<LONG> rcSrc_;
 	DxRect<float> rcDst_;
+	DxRect<float> rcTexCoord_;		//rcSrc_ normalized to the texture size
 
 	size_t frame_;
 public:
@@ -369,6 +410,7 @@ public:
 	static void _SetVertexColorARGB(VERTEX_TLX* vertex, D3DCOLOR color);
 protected:
 	virtual void _DeleteInLife();
+	bool _IsOutsideDeleteClip();
 	virtual void _DeleteInAutoClip();
 	virtual void _DeleteInFadeDelete();
 	virtual void _DeleteInAutoDeleteFrame();
@@ -380,12 +422,31 @@ protected:
 	void _RequestPlayerDeleteEvent(int hitObjectID);
 
 	inline void _DefaultShotRender(StgShotData* shotData, StgShotDataFrame* shotFrame, const D3DXMATRIX& matWorld, D3DCOLOR color);
+	static uint16_t _GetBlendBit(BlendMode blend) { return blend <= MODE_BLEND_ALPHA_INV ? (1U << blend) : 0U; }
+
+	enum RenderPart {
+		PART_DELAY,
+		PART_MAIN,
+		PART_COUNT,
+	};
+	//Blend mode the part draws in this frame, MODE_BLEND_NONE if it isn't drawn
+	//	Both GetRenderBlendMask and Render go through this, so a shot is only queued in blends it draws in
+	virtual BlendMode _GetRenderPartBlend(RenderPart part) = 0;
+	static BlendMode _GetBlendOrDefault(BlendMode blend, BlendMode blendDefault) {
+		return blend == MODE_BLEND_NONE ? blendDefault : blend;
+	}
 protected:
 	std::list<StgShotPatternTransform> listTransformationShotAct_;
 	int timerTransform_;
 	int timerTransformNext_;
 
 	void _ProcessTransformAct();
+
+	//Results of PrepareMovement, consumed by the following Work()
+	bool bMovementPrepared_;
+	int8_t clipPrepared_;			//-1 = none, 0 = inside, 1 = outside the delete clip
+	double posClipPrepared_[2];
+	bool bWorkedAhead_;				//Work() already ran this frame, the call from the object pass is skipped
 public:
 	StgShotObject(StgStageController* stageController);
 	virtual ~StgShotObject();
@@ -397,8 +458,18 @@ public:
 	virtual void Work();
 	virtual void Activate() {}
 
+	//Kinematic part of Work() that only touches this object, may be run from worker threads
+	virtual bool IsParallelMovementAllowed() { return false; }
+	virtual void PrepareMovement() {}
+	void WorkAhead() {
+		Work();
+		bWorkedAhead_ = true;
+	}
+
 	virtual void Render() {};
 	virtual void Render(BlendMode targetBlend) = 0;
+	//One bit (1 << blend) for every blend mode the object draws in this frame
+	uint16_t GetRenderBlendMask();
 
 	virtual void SetRenderTarget(shared_ptr<Texture> texture) { renderTarget_ = texture; }
 
@@ -494,6 +565,9 @@ protected:
 
 	void _AddIntersectionRelativeTarget();
 	virtual void _SendDeleteEvent(TypeDelete type);
+
+	void _WorkMovement();
+	virtual BlendMode _GetRenderPartBlend(RenderPart part);
 public:
 	StgNormalShotObject(StgStageController* stageController);
 	virtual ~StgNormalShotObject();
@@ -501,6 +575,8 @@ public:
 	virtual void Clone(DxScriptObjectBase* src);
 
 	virtual void Work();
+	virtual bool IsParallelMovementAllowed();
+	virtual void PrepareMovement();
 	virtual void Render(BlendMode targetBlend);
 
 	virtual void ClearShotObject() {
@@ -581,6 +657,7 @@ protected:
 	virtual void _DeleteInAutoClip();
 	virtual void _Move();
 	virtual void _SendDeleteEvent(TypeDelete type);
+	virtual BlendMode _GetRenderPartBlend(RenderPart part);
 public:
 	StgLooseLaserObject(StgStageController* stageController);
 
@@ -614,6 +691,7 @@ protected:
 
 	virtual void _DeleteInAutoClip();
 	virtual void _SendDeleteEvent(TypeDelete type);
+	virtual BlendMode _GetRenderPartBlend(RenderPart part);
 public:
 	StgStraightLaserObject(StgStageController* stageController);
 
@@ -670,6 +748,7 @@ protected:
 	virtual void _DeleteInAutoClip();
 	virtual void _Move();
 	virtual void _SendDeleteEvent(TypeDelete type);
+	virtual BlendMode _GetRenderPartBlend(RenderPart part);
 public:
 	StgCurveLaserObject(StgStageController* stageController);
 
@@ -9,6 +9,8 @@
 StgStageController::StgStageController(StgSystemController* systemController) {
 	systemController_ = systemController;
 	infoSystem_ = systemController_->GetSystemInformation();
+
+	frameReplaySeek_ = 0;
 }
 StgStageController::~StgStageController() {
 	if (scriptManager_) {
@@ -16,6 +18,8 @@ StgStageController::~StgStageController() {
 	}
 }
 void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData) {
+	auto timeInitialize = SystemUtility::GetCpuTime();
+
 	ELogger* logger = ELogger::GetInstance();
 	auto infoLog = logger->GetInfoPanel();
 
@@ -59,8 +63,10 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 			keyReplayManager_->AddTarget(key);
 		}
 
-		if (replayStageData == nullptr)
+		if (replayStageData == nullptr) {
 			replayStageData.reset(new ReplayInformation::StageData());
+			replayStageData->SetStateHashInterval(DnhConfiguration::GetInstance()->replayStateHashInterval_);
+		}
 		infoStage_->SetReplayData(replayStageData);
 	}
 
@@ -143,26 +149,52 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 	ELogger::WriteTop(StringUtility::Format(L"Main script: [%s]", 
 		PathProperty::ReduceModuleDirectory(infoMain->pathScript_).c_str()));
 
-	{
-		std::wstring pathSystemScript = infoMain->pathSystem_;
-		if (pathSystemScript == ScriptInformation::DEFAULT)
-			pathSystemScript = EPathProperty::GetStgDefaultScriptDirectory() + L"Default_System.txt";
-		if (pathSystemScript.size() > 0) {
-			pathSystemScript = EPathProperty::ExtendRelativeToFull(dirInfo, pathSystemScript);
-			ELogger::WriteTop(StringUtility::Format(L"System script: [%s]", 
-				PathProperty::ReduceModuleDirectory(pathSystemScript).c_str()));
-
-			auto script = scriptManager_->LoadScript(
-				scriptManager_, pathSystemScript, StgStageScript::TYPE_SYSTEM);
-			scriptManager_->StartScript(script);
-		}
-	}
+	std::wstring pathSystemScript = infoMain->pathSystem_;
+	if (pathSystemScript == ScriptInformation::DEFAULT)
+		pathSystemScript = EPathProperty::GetStgDefaultScriptDirectory() + L"Default_System.txt";
+	if (pathSystemScript.size() > 0)
+		pathSystemScript = EPathProperty::ExtendRelativeToFull(dirInfo, pathSystemScript);
 
-	ref_unsync_ptr<StgPlayerObject> objPlayer = nullptr;
 	ref_count_ptr<ScriptInformation> infoPlayer = infoStage_->GetPlayerScriptInformation();
 	const std::wstring& pathPlayerScript = infoPlayer->pathScript_;
 
-	if (pathPlayerScript.size() > 0) {
+	std::wstring pathMainScript = infoMain->pathScript_;
+	if (infoMain->type_ == ScriptInformation::TYPE_SINGLE)
+		pathMainScript = EPathProperty::GetSystemResourceDirectory() + L"script/System_SingleStage.txt";
+	else if (infoMain->type_ == ScriptInformation::TYPE_PLURAL)
+		pathMainScript = EPathProperty::GetSystemResourceDirectory() + L"script/System_PluralStage.txt";
+
+	std::wstring pathBack = infoMain->pathBackground_;
+	if (pathBack == ScriptInformation::DEFAULT)
+		pathBack = L"";
+	if (pathBack.size() > 0)
+		pathBack = EPathProperty::ExtendRelativeToFull(dirInfo, pathBack);
+
+	//Compile the stage's scripts together on the load workers, they're still loaded and started in order below.
+	//	Script IDs are only issued when each one is loaded, so scripts loaded by the system script's @Initialize
+	//	get the same IDs as when everything was created and compiled one by one.
+	auto _CompileScript = [&](const std::wstring& path, int type) -> shared_ptr<ManagedScript> {
+		if (path.size() == 0) return nullptr;
+		shared_ptr<ManagedScript> script = scriptManager_->CreateDetached(type);
+		scriptManager_->CompileScriptAsync(path, script);
+		return script;
+	};
+	shared_ptr<ManagedScript> scriptSystem = _CompileScript(pathSystemScript, StgStageScript::TYPE_SYSTEM);
+	shared_ptr<ManagedScript> scriptPlayer = _CompileScript(pathPlayerScript, StgStageScript::TYPE_PLAYER);
+	shared_ptr<ManagedScript> scriptMain = _CompileScript(pathMainScript, StgStageScript::TYPE_STAGE);
+	shared_ptr<ManagedScript> scriptBack = _CompileScript(pathBack, StgStageScript::TYPE_STAGE);
+
+	if (scriptSystem) {
+		ELogger::WriteTop(StringUtility::Format(L"System script: [%s]", 
+			PathProperty::ReduceModuleDirectory(pathSystemScript).c_str()));
+
+		scriptSystem->SetScriptManager(scriptManager_);
+		scriptManager_->LoadScript(pathSystemScript, scriptSystem);
+		scriptManager_->StartScript(scriptSystem);
+	}
+
+	ref_unsync_ptr<StgPlayerObject> objPlayer = nullptr;
+	if (scriptPlayer) {
 		ELogger::WriteTop(StringUtility::Format(L"Player script: [%s]", 
 			PathProperty::ReduceModuleDirectory(pathPlayerScript).c_str()));
 		int idPlayer = scriptManager_->GetObjectManager()->CreatePlayerObject();
@@ -171,16 +203,16 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 		if (systemController_->GetSystemInformation()->IsPackageMode())
 			objPlayer->SetEnableStateEnd(false);
 
-		auto script = scriptManager_->LoadScript(
-			scriptManager_, pathPlayerScript, StgStageScript::TYPE_PLAYER);
-		_SetupReplayTargetCommonDataArea(script);
+		scriptPlayer->SetScriptManager(scriptManager_);
+		scriptManager_->LoadScript(pathPlayerScript, scriptPlayer);
+		_SetupReplayTargetCommonDataArea(scriptPlayer);
 
-		shared_ptr<StgStagePlayerScript> scriptPlayer =
-			std::dynamic_pointer_cast<StgStagePlayerScript>(script);
-		objPlayer->SetScript(scriptPlayer.get());
+		shared_ptr<StgStagePlayerScript> pPlayerScript =
+			std::dynamic_pointer_cast<StgStagePlayerScript>(scriptPlayer);
+		objPlayer->SetScript(pPlayerScript.get());
 
-		scriptManager_->SetPlayerScript(script);
-		scriptManager_->StartScript(script);
+		scriptManager_->SetPlayerScript(scriptPlayer);
+		scriptManager_->StartScript(scriptPlayer);
 
 		if (prevPlayerInfo)
 			objPlayer->SetPlayerInformation(prevPlayerInfo);
@@ -188,40 +220,20 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 	if (objPlayer)
 		infoStage_->SetPlayerObjectInformation(objPlayer->GetPlayerInformation());
 
-	if (infoMain->type_ == ScriptInformation::TYPE_SINGLE) {
-		std::wstring pathMainScript = EPathProperty::GetSystemResourceDirectory() + L"script/System_SingleStage.txt";
-		auto script = scriptManager_->LoadScript(
-			scriptManager_, pathMainScript, StgStageScript::TYPE_STAGE);
-		scriptManager_->StartScript(script);
-	}
-	else if (infoMain->type_ == ScriptInformation::TYPE_PLURAL) {
-		std::wstring pathMainScript = EPathProperty::GetSystemResourceDirectory() + L"script/System_PluralStage.txt";
-		auto script = scriptManager_->LoadScript(
-			scriptManager_, pathMainScript, StgStageScript::TYPE_STAGE);
-		scriptManager_->StartScript(script);
-	}
-	else {
-		const std::wstring& pathMainScript = infoMain->pathScript_;
-		if (pathMainScript.size() > 0) {
-			auto script = scriptManager_->LoadScript(
-				scriptManager_, pathMainScript, StgStageScript::TYPE_STAGE);
-			_SetupReplayTargetCommonDataArea(script);
-			scriptManager_->StartScript(script);
-		}
+	if (scriptMain) {
+		scriptMain->SetScriptManager(scriptManager_);
+		scriptManager_->LoadScript(pathMainScript, scriptMain);
+		if (infoMain->type_ != ScriptInformation::TYPE_SINGLE && infoMain->type_ != ScriptInformation::TYPE_PLURAL)
+			_SetupReplayTargetCommonDataArea(scriptMain);
+		scriptManager_->StartScript(scriptMain);
 	}
 
-	{
-		std::wstring pathBack = infoMain->pathBackground_;
-		if (pathBack == ScriptInformation::DEFAULT)
-			pathBack = L"";
-		if (pathBack.size() > 0) {
-			pathBack = EPathProperty::ExtendRelativeToFull(dirInfo, pathBack);
-			ELogger::WriteTop(StringUtility::Format(L"Background script: [%s]", 
-				PathProperty::ReduceModuleDirectory(pathBack).c_str()));
-			auto script = scriptManager_->LoadScript(
-				scriptManager_, pathBack, StgStageScript::TYPE_STAGE);
-			scriptManager_->StartScript(script);
-		}
+	if (scriptBack) {
+		ELogger::WriteTop(StringUtility::Format(L"Background script: [%s]", 
+			PathProperty::ReduceModuleDirectory(pathBack).c_str()));
+		scriptBack->SetScriptManager(scriptManager_);
+		scriptManager_->LoadScript(pathBack, scriptBack);
+		scriptManager_->StartScript(scriptBack);
 	}
 
 	if (!infoStage_->IsReplay()) {
@@ -240,6 +252,11 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 	}
 
 	infoStage_->SetStageStartTime(SystemUtility::GetCpuTime2());
+
+	if (infoLog) {
+		stdch::duration<double, std::milli> timeStart = SystemUtility::GetCpuTime() - timeInitialize;
+		infoLog->SetInfo(12, "Stage start", StringUtility::Format("%.2fms", timeStart.count()));
+	}
 }
 void StgStageController::CloseScene() {
 	EFpsController::GetInstance()->RemoveFpsControlObject(infoSlow_);
@@ -323,54 +340,11 @@ void StgStageController::Work() {
 	}
 	else {
 		if (!bCurrentPause) {
-			//Update replay keys
-			keyReplayManager_->Update();
-
-			//Clean up objects
-			objectManagerMain_->CleanupObject();
-
-			//Process all non-player scripts
-			scriptManager_->Work(StgStageScript::TYPE_SYSTEM);
-			scriptManager_->Work(StgStageScript::TYPE_STAGE);
-			scriptManager_->Work(StgStageScript::TYPE_SHOT);
-			scriptManager_->Work(StgStageScript::TYPE_ITEM);
-
-			ref_unsync_ptr<StgPlayerObject> objPlayer = GetPlayerObject();
-
-			//Move the player
-			if (objPlayer)
-				objPlayer->Move();
-			//Process the player script
-			scriptManager_->Work(StgStageScript::TYPE_PLAYER);
-
-			//Skip all this if the stage has already ended
-			if (infoStage_->IsEnd()) return;
-			objectManagerMain_->WorkObject();
-
-			enemyManager_->Work();
-			shotManager_->Work();
-			itemManager_->Work();
-
-			//Process intersections
-			enemyManager_->RegistIntersectionTarget();
-			shotManager_->RegistIntersectionTarget();
-			intersectionManager_->Work();
-
-			//Process graze events
-			if (objPlayer)
-				objPlayer->SendGrazeEvent();
-
-			if (!infoStage_->IsReplay()) {
-				//Add FPS entry to the replay data
-				DWORD stageFrame = infoStage_->GetCurrentFrame();
-				if (stageFrame % 60 == 0) {
-					ref_count_ptr<ReplayInformation::StageData> replayStageData = infoStage_->GetReplayData();
-					float framePerSecond = EFpsController::GetInstance()->GetCurrentFps();
-					replayStageData->AddFramePerSecond(framePerSecond);
-				}
-			}
+			_WorkFrame();
 
-			infoStage_->AdvanceFrame();
+			//Replays may simulate several frames per update, only the last one is rendered
+			if (infoStage_->IsReplay())
+				_WorkReplayFrames();
 		}
 		else {
 			pauseManager_->Work();
@@ -381,9 +355,81 @@ void StgStageController::Work() {
 	auto infoLog = logger->GetInfoPanel();
 
 	infoLog->SetInfo(6, "Shot count", std::to_string(shotManager_->GetShotCountAll()));
+	infoLog->SetInfo(3, "Shot render",
+		StringUtility::Format("Draw=%u, Batch=%u, Instance=%u", (uint32_t)shotManager_->GetRenderDrawCount(),
+			(uint32_t)shotManager_->GetRenderBatchCount(), (uint32_t)shotManager_->GetRenderInstanceCount()));
 	infoLog->SetInfo(7, "Enemy count", std::to_string(enemyManager_->GetEnemyCount()));
 	infoLog->SetInfo(8, "Item count", std::to_string(itemManager_->GetItemCount()));
 }
+void StgStageController::_WorkFrame() {
+	//Update replay keys
+	keyReplayManager_->Update();
+
+	//Clean up objects
+	objectManagerMain_->CleanupObject();
+
+	//Process all non-player scripts
+	scriptManager_->Work(StgStageScript::TYPE_SYSTEM);
+	scriptManager_->Work(StgStageScript::TYPE_STAGE);
+	scriptManager_->Work(StgStageScript::TYPE_SHOT);
+	scriptManager_->Work(StgStageScript::TYPE_ITEM);
+
+	ref_unsync_ptr<StgPlayerObject> objPlayer = GetPlayerObject();
+
+	//Move the player
+	if (objPlayer)
+		objPlayer->Move();
+	//Process the player script
+	scriptManager_->Work(StgStageScript::TYPE_PLAYER);
+
+	//Skip all this if the stage has already ended
+	if (infoStage_->IsEnd()) return;
+	shotManager_->WorkMovementParallel();
+	objectManagerMain_->WorkObject();
+
+	enemyManager_->Work();
+	shotManager_->Work();
+	itemManager_->Work();
+
+	//Process intersections
+	enemyManager_->RegistIntersectionTarget();
+	shotManager_->RegistIntersectionTarget();
+	intersectionManager_->Work();
+
+	//Process graze events
+	if (objPlayer)
+		objPlayer->SendGrazeEvent();
+
+	if (!infoStage_->IsReplay()) {
+		//Add FPS entry to the replay data
+		DWORD stageFrame = infoStage_->GetCurrentFrame();
+		if (stageFrame % 60 == 0) {
+			ref_count_ptr<ReplayInformation::StageData> replayStageData = infoStage_->GetReplayData();
+			float framePerSecond = EFpsController::GetInstance()->GetCurrentFps();
+			replayStageData->AddFramePerSecond(framePerSecond);
+		}
+	}
+
+	_WorkStateHash();
+
+	infoStage_->AdvanceFrame();
+}
+void StgStageController::_WorkReplayFrames() {
+	DWORD speed = systemController_->GetReplaySpeed();
+
+	auto timeStart = SystemUtility::GetCpuTime();
+	for (DWORD iFrame = 1; iFrame < speed || IsReplaySeeking(); ++iFrame) {
+		if (infoStage_->IsEnd() || infoStage_->IsPause()) break;
+
+		stdch::duration<double, std::milli> timeSpent = SystemUtility::GetCpuTime() - timeStart;
+		if (timeSpent.count() > REPLAY_FRAME_TIME_LIMIT) break;
+
+		_WorkFrame();
+	}
+}
+bool StgStageController::IsReplaySeeking() {
+	return infoStage_->IsReplay() && !infoStage_->IsEnd() && infoStage_->GetCurrentFrame() < frameReplaySeek_;
+}
 void StgStageController::Render() {
 	bool bPause = infoStage_->IsPause();
 	if (!bPause) {
@@ -426,6 +472,145 @@ void StgStageController::RenderToTransitionTexture() {
 	}
 	*/
 }
+void StgStageController::_WorkStateHash() {
+	ref_count_ptr<ReplayInformation::StageData> replayStageData = infoStage_->GetReplayData();
+	uint32_t interval = replayStageData->GetStateHashInterval();
+	if (interval == 0) return;
+
+	DWORD stageFrame = infoStage_->GetCurrentFrame();
+	if (stageFrame % interval != 0) return;
+
+	if (!infoStage_->IsReplay()) {
+		replayStageData->AddStateHash(ComputeStateHash());
+	}
+	else if (!infoStage_->IsReplayDesync()) {
+		const ReplayStateHash* hashReplay = replayStageData->GetStateHash(stageFrame);
+		if (hashReplay == nullptr) return;
+
+		uint32_t mask = ComputeStateHash().Compare(*hashReplay);
+		if (mask != 0) {
+			//Only the first divergence is reported, everything after it differs anyway
+			infoStage_->SetReplayDesync(stageFrame, mask);
+			Logger::WriteWarn(StringUtility::Format("Replay desynced at frame %u, differing state: %s",
+				stageFrame, ReplayStateHash::GetPartNames(mask).c_str()));
+		}
+	}
+}
+ReplayStateHash StgStageController::ComputeStateHash() {
+	ReplayStateHash res;
+
+	//FNV-1a, values are hashed by their bit patterns
+	uint64_t* hash = nullptr;
+	auto _Begin = [&](size_t part) {
+		hash = &res.hash[part];
+		*hash = 0xcbf29ce484222325ULL;
+	};
+	auto _HashBytes = [&](const void* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			*hash ^= ((const byte*)data)[i];
+			*hash *= 0x100000001b3ULL;
+		}
+	};
+	auto _Hash = [&](const auto& val) {
+		_HashBytes(&val, sizeof(val));
+	};
+
+	_Begin(ReplayStateHash::STAGE);
+	_Hash(infoStage_->GetCurrentFrame());
+	_Hash(infoStage_->GetScore());
+	_Hash(infoStage_->GetGraze());
+	_Hash(infoStage_->GetPoint());
+
+	_Begin(ReplayStateHash::RAND);
+	if (shared_ptr<RandProvider> rand = infoStage_->GetRandProvider()) {
+		const uint64_t* states = rand->GetStates();
+		for (size_t i = 0; i < 4; ++i)
+			_Hash(states[i]);
+	}
+
+	_Begin(ReplayStateHash::PLAYER);
+	if (ref_unsync_ptr<StgPlayerObject> objPlayer = GetPlayerObject()) {
+		ref_count_ptr<StgPlayerInformation> infoPlayer = objPlayer->GetPlayerInformation();
+		_Hash(objPlayer->GetState());
+		_Hash(objPlayer->GetPositionX());
+		_Hash(objPlayer->GetPositionY());
+		_Hash(infoPlayer->GetLife());
+		_Hash(infoPlayer->GetSpell());
+		_Hash(infoPlayer->GetPower());
+	}
+
+	auto _HashObject = [&](auto* obj) {
+		if (obj->IsDeleted()) return false;
+		_Hash(obj->GetObjectID());
+		_Hash(obj->GetPositionX());
+		_Hash(obj->GetPositionY());
+		return true;
+	};
+
+	_Begin(ReplayStateHash::SHOT);
+	for (auto& obj : shotManager_->GetShotList())
+		_HashObject(obj.get());
+
+	_Begin(ReplayStateHash::ENEMY);
+	for (auto& obj : enemyManager_->GetEnemyList()) {
+		if (_HashObject(obj.get()))
+			_Hash(obj->GetLife());
+	}
+
+	_Begin(ReplayStateHash::ITEM);
+	for (auto& obj : itemManager_->GetItemList())
+		_HashObject(obj.get());
+
+	_Begin(ReplayStateHash::COMMON_DATA);
+	{
+		auto _HashValue = [&](auto& self, const gstd::value& val) -> void {
+			if (!val.has_data()) {
+				_Hash((uint8_t)0xff);
+				return;
+			}
+
+			type_data::type_kind kind = val.get_type()->get_kind();
+			_Hash((uint8_t)kind);
+			switch (kind) {
+			case type_data::type_kind::tk_int:
+				_Hash(val.as_int());
+				break;
+			case type_data::type_kind::tk_float:
+				_Hash(val.as_float());
+				break;
+			case type_data::type_kind::tk_char:
+				_Hash(val.as_char());
+				break;
+			case type_data::type_kind::tk_boolean:
+				_Hash(val.as_boolean());
+				break;
+			case type_data::type_kind::tk_array:
+			{
+				uint32_t length = val.length_as_array();
+				_Hash(length);
+				for (size_t iArray = 0; iArray < length; ++iArray)
+					self(self, val[iArray]);
+				break;
+			}
+			}
+		};
+
+		//Only the areas the replay restores, others may have been loaded from files that changed since the recording
+		ScriptCommonDataManager* commonDataManager = systemController_->GetCommonDataManager();
+		for (auto& nameArea : infoStage_->GetReplayData()->GetCommonDataAreaList()) {
+			_HashBytes(nameArea.data(), nameArea.size() + 1);
+
+			ScriptCommonDataArea* area = commonDataManager->GetArea(nameArea);
+			if (area == nullptr) continue;
+			for (auto& [key, val] : *area) {
+				_HashBytes(key.data(), key.size() + 1);
+				_HashValue(_HashValue, val);
+			}
+		}
+	}
+
+	return res;
+}
 /*
 shared_ptr<DxScriptObjectBase> StgStageController::GetMainRenderObject(int idObject) {
 	return objectManagerMain_->GetObject(idObject);
@@ -463,6 +648,9 @@ StgStageInformation::StgStageInformation() {
 	point_ = 0;
 	result_ = RESULT_UNKNOWN;
 
+	frameDesync_ = 0;
+	maskDesync_ = 0;
+
 	timeStart_ = 0;
 }
 StgStageInformation::~StgStageInformation() {}
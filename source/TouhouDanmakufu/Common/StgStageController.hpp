@@ -18,6 +18,11 @@ class PseudoSlowInformation;
 //StgStageController
 //*******************************************************************
 class StgStageController {
+public:
+	enum {
+		//Longest time one update spends on extra replay frames, a seek carries on in the next update past this
+		REPLAY_FRAME_TIME_LIMIT = 50,
+	};
 private:
 	StgSystemController* systemController_;
 	ref_count_ptr<StgSystemInformation> infoSystem_;
@@ -35,7 +40,12 @@ private:
 	unique_ptr<StgItemManager> itemManager_;
 	unique_ptr<StgIntersectionManager> intersectionManager_;
 
+	DWORD frameReplaySeek_;
+
 	void _SetupReplayTargetCommonDataArea(shared_ptr<ManagedScript> pScript);
+	void _WorkFrame();
+	void _WorkReplayFrames();
+	void _WorkStateHash();
 public:
 	StgStageController(StgSystemController* systemController);
 	virtual ~StgStageController();
@@ -48,6 +58,15 @@ public:
 
 	void RenderToTransitionTexture();
 
+	//Simulates the replay up to the frame over the next updates, without rendering the frames in between
+	//	Only seeks forward, StgSystemController::SeekReplay restarts the stage for earlier frames
+	void SeekReplay(DWORD frame) { frameReplaySeek_ = frame; }
+	bool IsReplaySeeking();
+
+	//Hash of the simulation state (stage counters, RNG, player, every live shot, enemy and item, and the common data)
+	//	Equal between two runs of the same replay as long as they stay in sync
+	ReplayStateHash ComputeStateHash();
+
 	StgSystemController* GetSystemController() { return systemController_; }
 	ref_count_ptr<StgSystemInformation> GetSystemInformation() { return infoSystem_; }
 
@@ -107,6 +126,9 @@ private:
 
 	int result_;
 
+	DWORD frameDesync_;
+	uint32_t maskDesync_;	//Parts of ReplayStateHash that differed from the replay, 0 while in sync
+
 	uint64_t timeStart_;
 public:
 	StgStageInformation();
@@ -160,6 +182,11 @@ public:
 	int GetResult() { return result_; }
 	void SetResult(int result) { result_ = result; }
 
+	bool IsReplayDesync() { return maskDesync_ != 0; }
+	DWORD GetReplayDesyncFrame() { return frameDesync_; }
+	uint32_t GetReplayDesyncMask() { return maskDesync_; }
+	void SetReplayDesync(DWORD frame, uint32_t mask) { frameDesync_ = frame; maskDesync_ = mask; }
+
 	uint64_t GetStageStartTime() { return timeStart_; }
 	void SetStageStartTime(uint64_t time) { timeStart_ = time; }
 };
@@ -28,6 +28,12 @@ bool StgStageScriptManager::IsError() {
 }
 
 shared_ptr<ManagedScript> StgStageScriptManager::Create(shared_ptr<ScriptManager> manager, int type) {
+	shared_ptr<ManagedScript> res = CreateDetached(type);
+	if (res)
+		res->SetScriptManager(stageController_->GetScriptManager());
+	return res;
+}
+shared_ptr<ManagedScript> StgStageScriptManager::CreateDetached(int type) {
 	shared_ptr<ManagedScript> res = nullptr;
 	switch (type) {
 	case StgStageScript::TYPE_STAGE:
@@ -43,8 +49,6 @@ shared_ptr<ManagedScript> StgStageScriptManager::Create(shared_ptr<ScriptManager
 		res = make_shared<StgStagePlayerScript>(stageController_);
 		break;
 	}
-	if (res)
-		res->SetScriptManager(stageController_->GetScriptManager());
 	return res;
 }
 
@@ -253,6 +257,7 @@ static const std::vector<function> stgStageFunction = {
 	{ "GetReplayFps", StgStageScript::Func_GetReplayFps, 0 },
 	{ "SetIntersectionVisualization", StgStageScript::Func_SetIntersectionVisualization, 1 },
 	{ "SetIntersectionVisualizationRenderPriority", StgStageScript::Func_SetIntersectionVisualizationRenderPriority, 1 },
+	{ "SetIntersectionGridBroadphase", StgStageScript::Func_SetIntersectionGridBroadphase, 1 },
 
 	//STG共通関数：自機
 	{ "GetPlayerObjectID", StgStageScript::Func_GetPlayerObjectID, 0 },
@@ -334,6 +339,7 @@ static const std::vector<function> stgStageFunction = {
 	{ "GetShotDataInfoA1", StgStageScript::Func_GetShotDataInfoA1, 3 },
 	{ "SetShotDeleteEventEnable", StgStageScript::Func_SetShotDeleteEventEnable, 2 },
 	{ "SetShotTextureFilter", StgStageScript::Func_SetShotTextureFilter, 2 },
+	{ "SetShotParallelMovement", StgStageScript::Func_SetShotParallelMovement, 1 },
 
 	//STG共通関数：アイテム
 	{ "CreateItemA1", StgStageScript::Func_CreateItemA1, 4 },
@@ -986,6 +992,18 @@ gstd::value StgStageScript::Func_SetIntersectionVisualizationRenderPriority(gstd
 
 	return value();
 }
+gstd::value StgStageScript::Func_SetIntersectionGridBroadphase(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+
+	StgIntersectionManager* intersectionManager = stageController->GetIntersectionManager();
+	if (intersectionManager) {
+		intersectionManager->SetBroadphaseMode(argv[0].as_boolean() 
+			? StgIntersectionManager::BROADPHASE_GRID : StgIntersectionManager::BROADPHASE_ALLPAIRS);
+	}
+
+	return value();
+}
 
 //STG共通関数：自機
 gstd::value StgStageScript::Func_GetPlayerObjectID(gstd::script_machine* machine, int argc, const gstd::value* argv) {
@@ -1535,7 +1553,7 @@ gstd::value StgStageScript::Func_CreateShotA1(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1566,7 +1584,7 @@ gstd::value StgStageScript::Func_CreateShotA2(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1624,7 +1642,7 @@ gstd::value StgStageScript::Func_CreateShotOA1(gstd::script_machine* machine, in
 			double posX = tObj->GetPosition().x;
 			double posY = tObj->GetPosition().y;
 
-			ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+			ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 			id = script->AddObject(obj);
 			if (id != ID_INVALID) {
 				stageController->GetShotManager()->AddShot(obj);
@@ -1654,7 +1672,7 @@ gstd::value StgStageScript::Func_CreateShotB1(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1688,7 +1706,7 @@ gstd::value StgStageScript::Func_CreateShotB2(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1735,7 +1753,7 @@ gstd::value StgStageScript::Func_CreateShotOB1(gstd::script_machine* machine, in
 			double posX = tObj->GetPosition().x;
 			double posY = tObj->GetPosition().y;
 
-			ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+			ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 			id = script->AddObject(obj);
 			if (id != ID_INVALID) {
 				stageController->GetShotManager()->AddShot(obj);
@@ -1768,7 +1786,7 @@ gstd::value StgStageScript::Func_CreateShotC1(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1804,7 +1822,7 @@ gstd::value StgStageScript::Func_CreateShotC2(gstd::script_machine* machine, int
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+		ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1855,7 +1873,7 @@ gstd::value StgStageScript::Func_CreateShotOC1(gstd::script_machine* machine, in
 			double posX = tObj->GetPosition().x;
 			double posY = tObj->GetPosition().y;
 
-			ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+			ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 			id = script->AddObject(obj);
 			if (id != ID_INVALID) {
 				stageController->GetShotManager()->AddShot(obj);
@@ -1891,7 +1909,7 @@ gstd::value StgStageScript::Func_CreateLooseLaserA1(gstd::script_machine* machin
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgLooseLaserObject> obj(new StgLooseLaserObject(stageController));
+		ref_unsync_ptr<StgLooseLaserObject> obj = stageController->GetShotManager()->CreateShotObject<StgLooseLaserObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1927,7 +1945,7 @@ gstd::value StgStageScript::Func_CreateStraightLaserA1(gstd::script_machine* mac
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgStraightLaserObject> obj(new StgStraightLaserObject(stageController));
+		ref_unsync_ptr<StgStraightLaserObject> obj = stageController->GetShotManager()->CreateShotObject<StgStraightLaserObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -1962,7 +1980,7 @@ gstd::value StgStageScript::Func_CreateCurveLaserA1(gstd::script_machine* machin
 
 	int id = ID_INVALID;
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-		ref_unsync_ptr<StgCurveLaserObject> obj(new StgCurveLaserObject(stageController));
+		ref_unsync_ptr<StgCurveLaserObject> obj = stageController->GetShotManager()->CreateShotObject<StgCurveLaserObject>();
 		id = script->AddObject(obj);
 		if (id != ID_INVALID) {
 			stageController->GetShotManager()->AddShot(obj);
@@ -2236,6 +2254,15 @@ gstd::value StgStageScript::Func_SetShotTextureFilter(gstd::script_machine* mach
 
 	return value();
 }
+gstd::value StgStageScript::Func_SetShotParallelMovement(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+	StgShotManager* shotManager = stageController->GetShotManager();
+
+	shotManager->SetParallelMovementEnable(argv[0].as_boolean());
+
+	return value();
+}
 
 //STG共通関数：アイテム
 gstd::value StgStageScript::Func_CreateItemA1(gstd::script_machine* machine, int argc, const gstd::value* argv) {
@@ -4115,8 +4142,10 @@ gstd::value StgStageScript::Func_ObjShot_Create(gstd::script_machine* machine, i
 	if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
 		TypeObject type = (TypeObject)argv[0].as_int();
 
+		StgShotManager* shotManager = stageController->GetShotManager();
+
 		ref_unsync_ptr<StgShotObject> obj;
-#define DEF_CASE(_type, _class) case _type: obj.reset(new _class(stageController)); break;
+#define DEF_CASE(_type, _class) case _type: { auto objShot = shotManager->CreateShotObject<_class>(); obj = objShot; break; }
 		switch (type) {
 			DEF_CASE(TypeObject::Shot, StgNormalShotObject);
 			DEF_CASE(TypeObject::LooseLaser, StgLooseLaserObject);
@@ -5732,7 +5761,7 @@ gstd::value StgStagePlayerScript::Func_CreatePlayerShotA1(gstd::script_machine*
 	ref_unsync_ptr<StgPlayerObject> objPlayer = stageController->GetPlayerObject();
 	if (objPlayer) {
 		if (stageController->GetShotManager()->GetShotCountAll() < StgShotManager::SHOT_MAX) {
-			ref_unsync_ptr<StgNormalShotObject> obj(new StgNormalShotObject(stageController));
+			ref_unsync_ptr<StgNormalShotObject> obj = stageController->GetShotManager()->CreateShotObject<StgNormalShotObject>();
 			id = script->AddObject(obj);
 			if (id != ID_INVALID) {
 				stageController->GetShotManager()->AddShot(obj);
@@ -30,6 +30,8 @@ public:
 
 	shared_ptr<StgStageScriptObjectManager> GetObjectManager() { return objManager_; }
 	virtual shared_ptr<ManagedScript> Create(shared_ptr<ScriptManager> manager, int type) override;
+	//Creates a script without a manager or an ID, SetScriptManager must be called on it before it's loaded
+	shared_ptr<ManagedScript> CreateDetached(int type);
 
 	int64_t GetPlayerScriptID() { return idPlayerScript_; }
 	int64_t GetItemScriptID() { return idItemScript_; }
@@ -190,6 +192,7 @@ public:
 	static gstd::value Func_GetReplayFps(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	DNH_FUNCAPI_DECL_(Func_SetIntersectionVisualization);
 	DNH_FUNCAPI_DECL_(Func_SetIntersectionVisualizationRenderPriority);
+	DNH_FUNCAPI_DECL_(Func_SetIntersectionGridBroadphase);
 
 	//STG共通関数：自機
 	static gstd::value Func_GetPlayerObjectID(gstd::script_machine* machine, int argc, const gstd::value* argv);
@@ -282,6 +285,7 @@ public:
 	static gstd::value Func_GetShotDataInfoA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 	DNH_FUNCAPI_DECL_(Func_SetShotDeleteEventEnable);
 	DNH_FUNCAPI_DECL_(Func_SetShotTextureFilter);
+	DNH_FUNCAPI_DECL_(Func_SetShotParallelMovement);
 
 	//STG共通関数：アイテム
 	static gstd::value Func_CreateItemA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
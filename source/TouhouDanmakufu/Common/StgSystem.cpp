@@ -16,6 +16,8 @@ StgSystemController::StgSystemController() {
 	stageController_ = nullptr;
 	packageController_ = nullptr;
 	bPrevWindowFocused_ = true;
+
+	replaySpeed_ = 1;
 }
 StgSystemController::~StgSystemController() {
 	_ResetSystem();
@@ -144,7 +146,9 @@ void StgSystemController::Work() {
 		if (infoSystem_->IsError()) {
 			std::wstring error = infoSystem_->GetErrorMessage();
 			if (error.size() > 0) {
-				ErrorDialog::ShowErrorDialog(error);
+				//Headless runs report the error themselves in DoEnd
+				if (!DnhConfiguration::GetInstance()->bHeadless_)
+					ErrorDialog::ShowErrorDialog(error);
 			}
 			else {
 				bRetry = true;
@@ -425,7 +429,7 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 				}
 				if (pRenderListStage != nullptr && iPri < pRenderListStage->size()) {
 					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
-						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(*itr)) {
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
 							obj->Render();
@@ -467,7 +471,7 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 
 				if (pRenderListPackage != nullptr && iPri < pRenderListPackage->size()) {
 					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
-						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(*itr)) {
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
 							obj->Render();
@@ -566,6 +570,13 @@ void StgSystemController::_ControlScene() {
 	switch (scene) {
 	case StgSystemInformation::SCENE_STG:
 	{
+		//Seeking may replace the stage controller, which can't happen while its scripts are running
+		if (frameReplaySeek_) {
+			DWORD frame = *frameReplaySeek_;
+			frameReplaySeek_.reset();
+			_SeekReplay(frame);
+		}
+
 		ref_count_ptr<StgStageInformation> infoStage = stageController_->GetStageInformation();
 		if (!infoStage->IsEnd())
 			stageController_->Work();
@@ -649,6 +660,39 @@ void StgSystemController::_ControlScene() {
 	}
 }
 
+void StgSystemController::_SeekReplay(DWORD frame) {
+	ref_count_ptr<StgStageInformation> infoStage = stageController_->GetStageInformation();
+	if (!infoStage->IsReplay() || infoStage->IsEnd()) return;
+
+	if (frame < infoStage->GetCurrentFrame()) {
+		//Stages can't be rewound, restart it from the replay's stage data and simulate back up to the frame
+		DirectSoundManager* soundManager = DirectSoundManager::GetBase();
+		soundManager->Clear();
+
+		ref_count_ptr<StgStageStartData> newStageStartData(new StgStageStartData());
+		ref_count_ptr<StgStageInformation> newStageInformation(new StgStageInformation());
+
+		newStageInformation->SetMainScriptInformation(infoStage->GetMainScriptInformation());
+		newStageInformation->SetPlayerScriptInformation(infoStage->GetPlayerScriptInformation());
+		newStageInformation->SetStageIndex(infoStage->GetStageIndex());
+		newStageStartData->infoStage_ = newStageInformation;
+		newStageStartData->replayStageData_ = infoStage->GetReplayData();
+
+		if (infoSystem_->IsPackageMode()) {
+			ref_count_ptr<StgPackageInformation> infoPackage = packageController_->GetPackageInformation();
+			ref_count_ptr<StgStageStartData> oldStageStartData = infoPackage->GetNextStageData();
+			if (oldStageStartData) {
+				newStageStartData->prevStageInfo_ = oldStageStartData->prevStageInfo_;
+				newStageStartData->prevPlayerInfo_ = oldStageStartData->prevPlayerInfo_;
+			}
+			infoPackage->SetNextStageData(newStageStartData);
+		}
+
+		StartStgScene(newStageStartData);
+	}
+
+	stageController_->SeekReplay(frame);
+}
 void StgSystemController::StartStgScene(ref_count_ptr<StgStageInformation> infoStage, ref_count_ptr<ReplayInformation::StageData> replayStageData) {
 	ref_count_ptr<StgStageStartData> startData(new StgStageStartData());
 	startData->infoStage_ = infoStage;
@@ -41,9 +41,13 @@ protected:
 
 	bool bPrevWindowFocused_;
 
+	DWORD replaySpeed_;
+	optional<DWORD> frameReplaySeek_;
+
 	virtual void DoEnd() = 0;
 	virtual void DoRetry() = 0;
 	void _ControlScene();
+	void _SeekReplay(DWORD frame);
 
 	void _ResetSystem();
 public:
@@ -79,6 +83,12 @@ public:
 	void TransStgEndScene();
 	void TransReplaySaveScene();
 
+	//Stage frames simulated per update while a replay plays
+	DWORD GetReplaySpeed() { return replaySpeed_; }
+	void SetReplaySpeed(DWORD speed) { replaySpeed_ = std::max<DWORD>(speed, 1); }
+	//Takes effect at the start of the next update
+	void SeekReplay(DWORD frame) { frameReplaySeek_ = frame; }
+
 	ref_count_ptr<ReplayInformation> CreateReplayInformation();
 	void TerminateScriptAll();
 	std::vector<weak_ptr<ScriptManager>> GetScriptManagers();
@@ -0,0 +1,198 @@
+#include "source/GcLib/pch.h"
+
+#include "Benchmark.hpp"
+
+//*******************************************************************
+//BenchmarkRunner::BenchmarkScript
+//*******************************************************************
+class BenchmarkRunner::BenchmarkScript : public ScriptClientBase {
+public:
+	//Used by the -bench script mode only, no caching
+	BenchmarkScript(ScriptEngineCache* cache) { cache_ = cache; }
+};
+
+//*******************************************************************
+//BenchmarkRunner
+//*******************************************************************
+BenchmarkRunner::BenchmarkRunner() {
+	countRound_ = DEFAULT_ROUND;
+}
+
+bool BenchmarkRunner::Run(const wchar_t* cmdLine, int* exitCode) {
+	std::vector<std::wstring> listArg;
+	{
+		int argc = 0;
+		LPWSTR* argv = ::CommandLineToArgvW(cmdLine, &argc);
+		if (argv == nullptr) return false;
+
+		//Skip the executable path
+		for (int iArg = 1; iArg < argc; ++iArg)
+			listArg.push_back(argv[iArg]);
+		::LocalFree(argv);
+	}
+
+	auto itrBench = std::find(listArg.begin(), listArg.end(), L"-bench");
+	if (itrBench == listArg.end()) return false;
+
+	BenchmarkRunner runner;
+	runner._AttachConsole();
+	runner.listArg_.assign(itrBench + 1, listArg.end());
+
+	*exitCode = RESULT_PASS;
+	try {
+		std::wstring mode = runner.listArg_.size() > 0 ? runner.listArg_[0] : L"";
+		if (mode == L"jobs") {
+			if (runner.listArg_.size() > 1)
+				runner.countRound_ = std::max(StringUtility::ToInteger(runner.listArg_[1]), 1);
+			runner._RunJobs();
+		}
+		else if (mode == L"script" && runner.listArg_.size() > 1) {
+			if (runner.listArg_.size() > 2)
+				runner.countRound_ = std::max(StringUtility::ToInteger(runner.listArg_[2]), 1);
+			runner._RunScript(PathProperty::GetUnique(PathProperty::ExtendRelativeToFull(
+				PathProperty::GetModuleDirectory(), runner.listArg_[1])));
+		}
+		else
+			throw gstd::wexception("Usage: -bench jobs [rounds]\n       -bench script <script file> [rounds]");
+	}
+	catch (gstd::wexception& e) {
+		runner._Print("error: %s\n", StringUtility::ConvertWideToMulti(e.what()).c_str());
+		*exitCode = RESULT_ERROR;
+	}
+	catch (std::exception& e) {
+		runner._Print("error: %s\n", e.what());
+		*exitCode = RESULT_ERROR;
+	}
+
+	fflush(stdout);
+	return true;
+}
+
+void BenchmarkRunner::_AttachConsole() {
+	//Same as HeadlessRunner, release builds have no console of their own
+	HANDLE hStdOut = ::GetStdHandle(STD_OUTPUT_HANDLE);
+	if (hStdOut == nullptr || hStdOut == INVALID_HANDLE_VALUE) {
+		if (::AttachConsole(ATTACH_PARENT_PROCESS)) {
+			FILE* fp = nullptr;
+			freopen_s(&fp, "CONOUT$", "w", stdout);
+		}
+	}
+}
+void BenchmarkRunner::_Print(const char* format, ...) {
+	va_list vl;
+	va_start(vl, format);
+	vfprintf(stdout, format, vl);
+	va_end(vl);
+}
+
+template<class F>
+void BenchmarkRunner::_Measure(const char* name, size_t countCall, F&& func) {
+	//One untimed round to start the workers and warm the caches
+	for (size_t i = 0; i < countCall; ++i)
+		func();
+
+	std::vector<double> listTime(countRound_);	//Nanoseconds per call
+	for (double& time : listTime) {
+		auto timeStart = SystemUtility::GetCpuTime();
+		for (size_t i = 0; i < countCall; ++i)
+			func();
+		stdch::duration<double, std::nano> timeRound = SystemUtility::GetCpuTime() - timeStart;
+		time = timeRound.count() / countCall;
+	}
+	std::sort(listTime.begin(), listTime.end());
+
+	_Print("%-32s %10.1fns min %10.1fns median\n", name, listTime.front(), listTime[listTime.size() / 2]);
+}
+
+void BenchmarkRunner::_RunJobs() {
+	JobSystem* jobSystem = JobSystem::GetBase();
+	size_t countWorker = jobSystem->GetWorkerCount();
+	size_t countThread = countWorker + 1;
+	_Print("workers: %u, rounds: %u\n", (uint32_t)countWorker, (uint32_t)countRound_);
+
+	//Keeps the loop bodies from being optimized away
+	std::vector<std::atomic<uint32_t>> listSink(countThread * 16);
+	auto _Touch = [&](size_t index) {
+		listSink[(index % countThread) * 16].fetch_add(1, std::memory_order_relaxed);
+	};
+
+	const size_t COUNT_CALL = 10000;
+
+	_Measure("serial, 1 index", COUNT_CALL, [&]() {
+		_Touch(0);
+	});
+	_Measure("Run, 1 index per thread", COUNT_CALL, [&]() {
+		jobSystem->Run(countThread, _Touch);
+	});
+	_Measure("Run, 16 indices per thread", COUNT_CALL, [&]() {
+		jobSystem->Run(countThread * 16, _Touch);
+	});
+
+	//The loop sizes the shot and intersection passes see, on both sides of the parallel threshold
+	for (size_t countLoop : { 256U, 4096U, 65536U }) {
+		std::vector<float> listValue(countLoop, 1.0f);
+		auto _Work = [&](size_t i) {
+			listValue[i] = listValue[i] * 0.999f + 0.001f;
+		};
+
+		std::string nameSerial = StringUtility::Format("serial, %u items", (uint32_t)countLoop);
+		_Measure(nameSerial.c_str(), COUNT_CALL / 10, [&]() {
+			for (size_t i = 0; i < countLoop; ++i)
+				_Work(i);
+		});
+		std::string nameChunk = StringUtility::Format("ParallelForChunk, %u items", (uint32_t)countLoop);
+		_Measure(nameChunk.c_str(), COUNT_CALL / 10, [&]() {
+			ParallelForChunk(countLoop, [&](size_t, size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					_Work(i);
+			});
+		});
+		std::string nameFor = StringUtility::Format("ParallelFor, %u items", (uint32_t)countLoop);
+		_Measure(nameFor.c_str(), COUNT_CALL / 10, [&]() {
+			ParallelFor(countLoop, _Work);
+		});
+	}
+}
+void BenchmarkRunner::_RunScript(const std::wstring& path) {
+	//Scripts read their source and #include files through the file manager
+	FileManager fileManager;
+	fileManager.Initialize();
+
+	ScriptEngineCache cache;
+	BenchmarkScript script(&cache);
+
+	{
+		auto timeStart = SystemUtility::GetCpuTime();
+		script.SetSourceFromFile(path);
+		script.Compile();
+		stdch::duration<double, std::milli> timeCompile = SystemUtility::GetCpuTime() - timeStart;
+
+		_Print("script: %s\n", StringUtility::ConvertWideToMulti(PathProperty::GetFileName(path)).c_str());
+		_Print("compile: %.3fms\n", timeCompile.count());
+	}
+
+	std::map<std::string, script_block*>::iterator itrInitialize;
+	bool bInitialize = script.IsEventExists("Initialize", itrInitialize);
+
+	std::vector<double> listTime(countRound_);	//Milliseconds
+	for (double& time : listTime) {
+		script.Reset();
+
+		auto timeStart = SystemUtility::GetCpuTime();
+		script.Run();
+		if (bInitialize)
+			script.Run(itrInitialize);
+		stdch::duration<double, std::milli> timeRound = SystemUtility::GetCpuTime() - timeStart;
+		time = timeRound.count();
+	}
+	std::sort(listTime.begin(), listTime.end());
+
+	_Print("rounds: %u\n", (uint32_t)countRound_);
+	_Print("run: %.3fms min, %.3fms median, %.3fms max\n", listTime.front(),
+		listTime[listTime.size() / 2], listTime.back());
+
+	//Lets scripts check that a change kept their behavior
+	value valueRes = script.GetResultValue();
+	if (valueRes.has_data())
+		_Print("result: %s\n", StringUtility::ConvertWideToMulti(valueRes.as_string()).c_str());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../../GcLib/pch.h"
+
+#include "GcLibImpl.hpp"
+
+//*******************************************************************
+//BenchmarkRunner
+//	Microbenchmarks run from the command line instead of starting the game.
+//	Prints the fastest and median time of every case over a number of rounds.
+//
+//	th_dnh.exe -bench jobs [rounds]
+//		Per-call overhead of JobSystem::Run and the ParallelFor helpers against a plain loop
+//	th_dnh.exe -bench script <script file> [rounds]
+//		Compiles the script once, then every round resets it and runs its main block and @Initialize.
+//		Only the common script functions are available. Scripts to run it with are in bench/script.
+//		Prints the value passed to SetScriptResult in the last round, if any.
+//*******************************************************************
+class BenchmarkRunner {
+public:
+	enum {
+		RESULT_PASS = 0,
+		RESULT_ERROR = 2,
+
+		DEFAULT_ROUND = 20,
+	};
+private:
+	class BenchmarkScript;
+
+	std::vector<std::wstring> listArg_;
+	size_t countRound_;
+
+	void _AttachConsole();
+	void _Print(const char* format, ...);
+
+	//Times countRound_ rounds of countCall calls to func and prints the per-call cost
+	template<class F> void _Measure(const char* name, size_t countCall, F&& func);
+
+	void _RunJobs();
+	void _RunScript(const std::wstring& path);
+public:
+	BenchmarkRunner();
+
+	//Returns false if the command line has no -bench option, otherwise runs it and sets the exit code
+	static bool Run(const wchar_t* cmdLine, int* exitCode);
+};
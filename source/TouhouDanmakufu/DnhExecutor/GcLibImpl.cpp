@@ -3,6 +3,7 @@
 #include "GcLibImpl.hpp"
 #include "System.hpp"
 #include "StgScene.hpp"
+#include "Headless.hpp"
 
 #include "../Common/DnhConfiguration.hpp"
 
@@ -11,6 +12,7 @@
 //*******************************************************************
 EApplication::EApplication() {
 	ptrGraphics = nullptr;
+	bWindowFocused_ = false;
 }
 EApplication::~EApplication() {
 }
@@ -65,7 +67,10 @@ bool EApplication::_Initialize() {
 	textRenderer->Initialize();
 
 	EDirectSoundManager* soundManager = EDirectSoundManager::CreateInstance();
-	soundManager->Initialize(hWndDisplay);
+	if (config->bHeadless_)
+		soundManager->InitializeSilent();
+	else
+		soundManager->Initialize(hWndDisplay);
 
 	EDirectInput* input = EDirectInput::CreateInstance();
 	input->Initialize(hWndDisplay);
@@ -73,6 +78,8 @@ bool EApplication::_Initialize() {
 	ETaskManager* taskManager = ETaskManager::CreateInstance();
 	taskManager->Initialize();
 
+	ScriptClientBase::SetBytecodeCacheDirectory(EPathProperty::GetScriptCacheDirectory());
+
 	{
 		{
 			auto logPanel = logger->GetEventLog();
@@ -119,8 +126,8 @@ bool EApplication::_Initialize() {
 			auto panelSound = make_shared<directx::SoundInfoPanel>();
 			panelSound->SetDisplayName("Sound");
 
-			// Updated in DirectSoundManager
-			if (logger->EAddPanelNoUpdate(panelSound, L"Sound"))
+			// Updated in DirectSoundManager, which has no device to report on in headless runs
+			if (logger->EAddPanelNoUpdate(panelSound, L"Sound") && !config->bHeadless_)
 				soundManager->SetInfoPanel(panelSound);
 		}
 
@@ -142,8 +149,13 @@ bool EApplication::_Initialize() {
 	logger->LoadState();
 	logger->SetWindowVisible(config->bLogWindow_);
 
-	SystemController* systemController = SystemController::CreateInstance();
-	systemController->Reset();
+	if (config->bHeadless_) {
+		HeadlessRunner::GetInstance()->Start();
+	}
+	else {
+		SystemController* systemController = SystemController::CreateInstance();
+		systemController->Reset();
+	}
 
 	Logger::WriteTop("Application initialized.");
 
@@ -157,6 +169,17 @@ bool EApplication::_Loop() {
 	EDirectGraphics* graphics = EDirectGraphics::GetInstance();
 	DnhConfiguration* config = DnhConfiguration::GetInstance();
 
+	if (config->bHeadless_) {
+		//No frame pacing, input or rendering, just run the logic until the runner is done
+		HeadlessRunner* runner = HeadlessRunner::GetInstance();
+		bWindowFocused_ = true;
+
+		runner->Work();
+		if (runner->IsFinished())
+			End();
+		return true;
+	}
+
 	HWND hWndFocused = ::GetForegroundWindow();
 	HWND hWndGraphics = graphics->GetWindowHandle();
 	HWND hWndLogger = logger->GetWindowHandle();
@@ -457,11 +480,12 @@ bool EDirectGraphics::Initialize(const std::wstring& windowTitle) {
 	DirectGraphicsConfig dxConfig;
 	dxConfig.sizeScreen = { screenWidth, screenHeight };
 	dxConfig.sizeScreenDisplay = { windowedWidth, windowedHeight };
-	dxConfig.bShowWindow = true;
+	dxConfig.bShowWindow = !dnhConfig->bHeadless_;
 	dxConfig.bShowCursor = dnhConfig->bMouseVisible_;
 	dxConfig.colorMode = dnhConfig->modeColor_;
 	dxConfig.bVSync = dnhConfig->bVSync_;
 	dxConfig.bUseRef = dnhConfig->bUseRef_;
+	dxConfig.bUseNullRef = dnhConfig->bHeadless_;
 	dxConfig.typeMultiSample = dnhConfig->multiSamples_;
 	dxConfig.bBorderlessFullscreen = dnhConfig->bPseudoFullscreen_;
 
@@ -484,7 +508,7 @@ bool EDirectGraphics::Initialize(const std::wstring& windowTitle) {
 		}
 		*/
 
-		if (windowedWidth > monitorWd || windowedHeight > monitorHt) {
+		if (!dnhConfig->bHeadless_ && (windowedWidth > monitorWd || windowedHeight > monitorHt)) {
 			std::wstring msg = StringUtility::Format(L"Your monitor size (usable=%dx%d) is too small "
 				"for the game's window size (%dx%d).\n\nAdjust the window size to fit?",
 				monitorWd, monitorHt, windowedWidth, windowedHeight);
@@ -520,8 +544,11 @@ bool EDirectGraphics::Initialize(const std::wstring& windowTitle) {
 
 		SetWindowTitle(windowTitle);
 
-		ChangeScreenMode(screenMode, false);
-		SetWindowVisible(true);
+		//Headless runs keep the window hidden, D3D9 needs it as the focus window of the null device
+		if (!dnhConfig->bHeadless_) {
+			ChangeScreenMode(screenMode, false);
+			SetWindowVisible(true);
+		}
 	}
 
 	return res;
@@ -0,0 +1,262 @@
+#include "source/GcLib/pch.h"
+
+#include "Headless.hpp"
+#include "StgScene.hpp"
+
+#include "../Common/DnhConfiguration.hpp"
+
+//*******************************************************************
+//HeadlessRunner
+//*******************************************************************
+HeadlessRunner::HeadlessRunner() {
+	frameEnd_ = 0;
+	scoreExpected_ = 0;
+
+	bFinished_ = false;
+	exitCode_ = RESULT_PASS;
+}
+HeadlessRunner::~HeadlessRunner() {
+	fflush(stdout);
+}
+
+bool HeadlessRunner::ParseCommandLine(const wchar_t* cmdLine) {
+	std::vector<std::wstring> listArg;
+	{
+		int argc = 0;
+		LPWSTR* argv = ::CommandLineToArgvW(cmdLine, &argc);
+		if (argv == nullptr) return false;
+
+		//Skip the executable path
+		for (int iArg = 1; iArg < argc; ++iArg)
+			listArg.push_back(argv[iArg]);
+		::LocalFree(argv);
+	}
+
+	auto itrHeadless = std::find(listArg.begin(), listArg.end(), L"-headless");
+	if (itrHeadless == listArg.end()) return false;
+
+	HeadlessRunner* runner = HeadlessRunner::CreateInstance();
+	runner->_AttachConsole();
+
+	//Missing paths are reported by Start
+	if (std::distance(itrHeadless, listArg.end()) >= 3) {
+		auto _GetFullPath = [](const std::wstring& path) {
+			return PathProperty::GetUnique(PathProperty::ExtendRelativeToFull(
+				PathProperty::GetModuleDirectory(), path));
+		};
+		runner->pathMainScript_ = _GetFullPath(itrHeadless[1]);
+		runner->pathReplay_ = _GetFullPath(itrHeadless[2]);
+	}
+
+	DnhConfiguration* config = DnhConfiguration::GetInstance();
+	config->bHeadless_ = true;
+	config->bLogWindow_ = false;
+	config->bVSync_ = false;
+	config->modeScreen_ = ScreenMode::SCREENMODE_WINDOW;
+	config->bEnableUnfocusedProcessing_ = false;
+
+	return true;
+}
+
+void HeadlessRunner::_AttachConsole() {
+	//Release builds use the Windows subsystem, print to the console of whoever launched us unless stdout was redirected
+	HANDLE hStdOut = ::GetStdHandle(STD_OUTPUT_HANDLE);
+	if (hStdOut == nullptr || hStdOut == INVALID_HANDLE_VALUE) {
+		if (::AttachConsole(ATTACH_PARENT_PROCESS)) {
+			FILE* fp = nullptr;
+			freopen_s(&fp, "CONOUT$", "w", stdout);
+		}
+	}
+}
+void HeadlessRunner::_Print(const char* format, ...) {
+	va_list vl;
+	va_start(vl, format);
+	vfprintf(stdout, format, vl);
+	va_end(vl);
+}
+
+void HeadlessRunner::Start() {
+	try {
+		if (pathMainScript_.size() == 0 || pathReplay_.size() == 0)
+			throw gstd::wexception("Usage: -headless <main script> <replay file>");
+
+		ref_count_ptr<ScriptInformation> infoMain = ScriptInformation::CreateScriptInformation(pathMainScript_);
+		if (infoMain == nullptr)
+			throw gstd::wexception(ErrorUtility::GetFileNotFoundErrorMessage(pathMainScript_, true));
+		if (infoMain->type_ == ScriptInformation::TYPE_PACKAGE)
+			throw gstd::wexception("Package scripts cannot be played back headless, use the stage's main script instead.");
+
+		ref_count_ptr<ReplayInformation> infoReplay = ReplayInformation::CreateFromFile(pathReplay_);
+		if (infoReplay == nullptr)
+			throw gstd::wexception(L"Invalid replay file: " + pathReplay_);
+
+		ref_count_ptr<ReplayInformation::StageData> replayStageData = infoReplay->GetStageData(0);
+		if (replayStageData == nullptr)
+			throw gstd::wexception(L"Replay file has no stage data: " + pathReplay_);
+		frameEnd_ = replayStageData->GetEndFrame();
+		scoreExpected_ = replayStageData->GetLastScore();
+
+		//Same lookup as SceneManager::TransStgScene
+		ref_count_ptr<ScriptInformation> infoPlayer;
+		{
+			std::vector<ref_count_ptr<ScriptInformation>> listPlayer;
+			if (infoMain->listPlayer_.size() == 0)
+				listPlayer = ScriptInformation::FindPlayerScriptInformationList(EPathProperty::GetPlayerScriptRootDirectory());
+			else
+				listPlayer = infoMain->CreatePlayerScriptInformationList();
+
+			const std::wstring& replayPlayerID = infoReplay->GetPlayerScriptID();
+			const std::wstring& replayPlayerScriptFileName = infoReplay->GetPlayerScriptFileName();
+			for (auto& tInfo : listPlayer) {
+				if (tInfo->id_ != replayPlayerID) continue;
+				if (PathProperty::GetFileName(tInfo->pathScript_) != replayPlayerScriptFileName) continue;
+
+				infoPlayer = tInfo;
+				break;
+			}
+
+			if (infoPlayer == nullptr) {
+				throw gstd::wexception(StringUtility::Format(L"Player script not found: [%s]",
+					replayPlayerScriptFileName.c_str()));
+			}
+		}
+
+		ref_count_ptr<StgSystemInformation> infoStgSystem(new StgSystemInformation());
+		infoStgSystem->SetMainScriptInformation(infoMain);
+
+		shared_ptr<StgSystemController> task(new HStgSystemController());
+		task->Initialize(infoStgSystem);
+		task->Start(infoPlayer, infoReplay);
+
+		//No render function, the stage is never drawn
+		ETaskManager* taskManager = ETaskManager::GetInstance();
+		taskManager->AddTask(task);
+		taskManager->AddWorkFunction(TTaskFunction<StgSystemController>::Create(task,
+			&StgSystemController::Work), StgSystemController::TASK_PRI_WORK);
+
+		controller_ = task;
+	}
+	catch (gstd::wexception& e) {
+		Finish(e.what());
+	}
+}
+void HeadlessRunner::Work() {
+	if (bFinished_) return;
+
+	ETaskManager* taskManager = ETaskManager::GetInstance();
+	EDirectInput* input = EDirectInput::GetInstance();
+
+	//Only the replay's keys reach the stage
+	input->ClearKeyState();
+
+	auto timeStart = SystemUtility::GetCpuTime();
+	taskManager->CallWorkFunction();
+	stdch::duration<double, std::milli> timeFrame = SystemUtility::GetCpuTime() - timeStart;
+
+	listFrameTime_.push_back(timeFrame.count());
+	_Print("frame %u: %.3fms\n", (uint32_t)listFrameTime_.size(), timeFrame.count());
+
+	if (listFrameTime_.size() % 120 == 0)
+		taskManager->ArrangeTask();
+
+	if (bFinished_) return;
+
+	if (auto controller = controller_.lock()) {
+		StgStageController* stageController = controller->GetStageController();
+		if (stageController) {
+			ref_count_ptr<StgStageInformation> infoStage = stageController->GetStageInformation();
+			DWORD frame = infoStage->GetCurrentFrame();
+			if (infoStage->IsReplayDesync()) {
+				bFinished_ = true;
+				exitCode_ = RESULT_FAIL;
+
+				_PrintSummary(controller.get());
+				_PrintDesync(infoStage.get());
+				fflush(stdout);
+			}
+			else if (frame > frameEnd_ + FRAME_END_MARGIN) {
+				bFinished_ = true;
+				exitCode_ = RESULT_FAIL;
+
+				_PrintSummary(controller.get());
+				_Print("result: desync, the stage was still running at frame %u (replay ended at %u)\n",
+					frame, frameEnd_);
+				fflush(stdout);
+			}
+		}
+	}
+}
+bool HeadlessRunner::_PrintSummary(StgSystemController* controller) {
+	{
+		double timeTotal = 0;
+		double timeMax = 0;
+		for (double time : listFrameTime_) {
+			timeTotal += time;
+			timeMax = std::max(timeMax, time);
+		}
+		size_t countFrame = listFrameTime_.size();
+		_Print("frames: %u\n", (uint32_t)countFrame);
+		_Print("time: %.3fms total, %.3fms average, %.3fms max\n", timeTotal,
+			countFrame > 0 ? timeTotal / countFrame : 0.0, timeMax);
+	}
+
+	StgStageController* stageController = controller->GetStageController();
+	if (stageController == nullptr) return false;
+
+	ref_count_ptr<StgStageInformation> infoStage = stageController->GetStageInformation();
+	int64_t score = infoStage->GetScore();
+
+	_Print("score: %lld (replay: %lld)\n", score, scoreExpected_);
+	_Print("graze: %lld\n", infoStage->GetGraze());
+	_Print("point: %lld\n", infoStage->GetPoint());
+	_Print("state hash: %016llx\n", stageController->ComputeStateHash().Combine());
+
+	return score == scoreExpected_;
+}
+void HeadlessRunner::_PrintDesync(StgStageInformation* infoStage) {
+	_Print("result: desync at frame %u, differing state: %s\n", infoStage->GetReplayDesyncFrame(),
+		ReplayStateHash::GetPartNames(infoStage->GetReplayDesyncMask()).c_str());
+}
+void HeadlessRunner::Finish(StgSystemController* controller) {
+	if (bFinished_) return;
+
+	ref_count_ptr<StgSystemInformation> infoSystem = controller->GetSystemInformation();
+	if (infoSystem->IsError()) {
+		std::wstring error = infoSystem->GetErrorMessage();
+		if (error.size() > 0) {
+			Finish(error);
+			return;
+		}
+	}
+
+	bFinished_ = true;
+
+	bool bScoreMatch = _PrintSummary(controller);
+
+	StgStageController* stageController = controller->GetStageController();
+	if (stageController && stageController->GetStageInformation()->IsReplayDesync()) {
+		exitCode_ = RESULT_FAIL;
+		_PrintDesync(stageController->GetStageInformation().get());
+	}
+	else if (bScoreMatch) {
+		exitCode_ = RESULT_PASS;
+		_Print("result: pass\n");
+	}
+	else {
+		exitCode_ = RESULT_FAIL;
+		_Print("result: score mismatch\n");
+	}
+
+	fflush(stdout);
+}
+void HeadlessRunner::Finish(const std::wstring& error) {
+	if (bFinished_) return;
+
+	bFinished_ = true;
+	exitCode_ = RESULT_ERROR;
+
+	_Print("frames: %u\n", (uint32_t)listFrameTime_.size());
+	_Print("result: error\n%s\n", StringUtility::ConvertWideToMulti(error).c_str());
+
+	fflush(stdout);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../GcLib/pch.h"
+
+#include "GcLibImpl.hpp"
+#include "Common.hpp"
+
+//*******************************************************************
+//HeadlessRunner
+//	Plays a stage back from a replay with no visible window, sound or rendering, as fast as the logic runs.
+//	Prints the time of every frame, then the final score and state hash.
+//	Stops at the first frame whose state hash differs from the one recorded in the replay.
+//
+//	th_dnh.exe -headless <main script> <replay file>
+//*******************************************************************
+class StgSystemController;
+class StgStageInformation;
+class HeadlessRunner : public Singleton<HeadlessRunner> {
+	friend Singleton<HeadlessRunner>;
+public:
+	enum {
+		RESULT_PASS = 0,
+		RESULT_FAIL = 1,			//The replay desynced, or its score did not match
+		RESULT_ERROR = 2,			//Script error, or the stage could not be started
+
+		//Frames the stage may run past the replay's recorded end before it counts as desynced
+		FRAME_END_MARGIN = 60,
+	};
+private:
+	std::wstring pathMainScript_;
+	std::wstring pathReplay_;
+
+	DWORD frameEnd_;
+	int64_t scoreExpected_;
+
+	std::vector<double> listFrameTime_;	//Milliseconds
+	bool bFinished_;
+	int exitCode_;
+
+	weak_ptr<StgSystemController> controller_;
+
+	HeadlessRunner();
+
+	void _AttachConsole();
+	void _Print(const char* format, ...);
+	bool _PrintSummary(StgSystemController* controller);	//Returns whether the score matched the replay
+	void _PrintDesync(StgStageInformation* infoStage);
+public:
+	~HeadlessRunner();
+
+	//Returns false and leaves the runner uncreated if the command line has no -headless option
+	static bool ParseCommandLine(const wchar_t* cmdLine);
+
+	void Start();
+	void Work();
+	void Finish(StgSystemController* controller);
+	void Finish(const std::wstring& error);
+
+	bool IsFinished() { return bFinished_; }
+	int GetExitCode() { return exitCode_; }
+};
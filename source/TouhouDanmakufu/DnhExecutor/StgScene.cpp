@@ -2,6 +2,7 @@
 
 #include "StgScene.hpp"
 #include "System.hpp"
+#include "Headless.hpp"
 
 //*******************************************************************
 //EStgSystemController
@@ -47,3 +48,18 @@ void PStgSystemController::DoRetry() {
 	EShaderManager* shaderManager = EShaderManager::GetInstance();
 	shaderManager->Clear();
 }
+
+
+//*******************************************************************
+//HStgSystemController
+//*******************************************************************
+void HStgSystemController::DoEnd() {
+	HeadlessRunner::GetInstance()->Finish(this);
+
+	ETaskManager* taskManager = ETaskManager::GetInstance();
+	taskManager->RemoveTask(typeid(HStgSystemController));
+}
+void HStgSystemController::DoRetry() {
+	//Replays can't be retried, and there is nothing to retry into
+	DoEnd();
+}
\ No newline at end of file
@@ -17,6 +17,15 @@ protected:
 //PStgSystemController
 //*******************************************************************
 class PStgSystemController : public StgSystemController {
+protected:
+	virtual void DoEnd();
+	virtual void DoRetry();
+};
+
+//*******************************************************************
+//HStgSystemController
+//*******************************************************************
+class HStgSystemController : public StgSystemController {
 protected:
 	virtual void DoEnd();
 	virtual void DoRetry();
@@ -1,19 +1,29 @@
 #include "source/GcLib/pch.h"
 
 #include "GcLibImpl.hpp"
+#include "Headless.hpp"
+#include "Benchmark.hpp"
 
 //*******************************************************************
 //WinMain
 //*******************************************************************
 int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow) {
 	HWND handleWindow = nullptr;
+	int exitCode = 0;
 
 	try {
 		gstd::SystemUtility::InitializeCOM();
 		gstd::SystemUtility::TestCpuSupportSIMD();
 
+		//Runs without the window or any of the engine singletons
+		if (BenchmarkRunner::Run(::GetCommandLineW(), &exitCode)) {
+			gstd::SystemUtility::UninitializeCOM();
+			return exitCode;
+		}
+
 		directx::EDirect3D9::CreateInstance();
 		DnhConfiguration* config = DnhConfiguration::CreateInstance();
+		HeadlessRunner::ParseCommandLine(::GetCommandLineW());
 
 		ELogger* logger = ELogger::CreateInstance();
 		logger->Initialize(config->bLogFile_, config->bLogWindow_);
@@ -36,17 +46,33 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 			if (!bFinalize)
 				throw gstd::wexception("Finalization failure.");
 		}
+
+		if (HeadlessRunner* runner = HeadlessRunner::GetInstance())
+			exitCode = runner->GetExitCode();
 	}
 	catch (std::exception& e) {
-		MessageBox(handleWindow, StringUtility::ConvertMultiToWide(e.what()).c_str(),
-			L"Unexpected Error", MB_ICONERROR | MB_APPLMODAL | MB_OK);
+		if (HeadlessRunner* runner = HeadlessRunner::GetInstance()) {
+			runner->Finish(StringUtility::ConvertMultiToWide(e.what()));
+			exitCode = runner->GetExitCode();
+		}
+		else {
+			MessageBox(handleWindow, StringUtility::ConvertMultiToWide(e.what()).c_str(),
+				L"Unexpected Error", MB_ICONERROR | MB_APPLMODAL | MB_OK);
+		}
 	}
 	catch (gstd::wexception& e) {
-		MessageBox(handleWindow, e.what(), 
-			L"Engine Error", MB_ICONERROR | MB_APPLMODAL | MB_OK);
+		if (HeadlessRunner* runner = HeadlessRunner::GetInstance()) {
+			runner->Finish(e.what());
+			exitCode = runner->GetExitCode();
+		}
+		else {
+			MessageBox(handleWindow, e.what(),
+				L"Engine Error", MB_ICONERROR | MB_APPLMODAL | MB_OK);
+		}
 	}
 
 	EApplication::DeleteInstance();
+	HeadlessRunner::DeleteInstance();
 	EPathProperty::DeleteInstance();
 	ELogger::DeleteInstance();
 	DnhConfiguration::DeleteInstance();
@@ -55,5 +81,5 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmd
 	gstd::SystemUtility::UninitializeCOM();
 	gstd::DebugUtility::DumpMemoryLeaksOnExit();
 
-	return 0;
+	return exitCode;
 }